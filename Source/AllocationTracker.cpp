@@ -0,0 +1,100 @@
+#include "AllocationTracker.h"
+
+#if CLARITIZER_TRACK_ALLOCATIONS
+
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+
+static thread_local bool allocationsForbidden = false;
+
+ScopedAllocationGuard::ScopedAllocationGuard() noexcept
+    : wasForbidden(allocationsForbidden)
+{
+    allocationsForbidden = true;
+}
+
+ScopedAllocationGuard::~ScopedAllocationGuard() noexcept
+{
+    allocationsForbidden = wasForbidden;
+}
+
+static void checkAllocation() noexcept
+{
+    if (allocationsForbidden)
+    {
+        // Something allocated inside processBlock. The flag is dropped while the
+        // assertion runs because logging it may allocate as well.
+        allocationsForbidden = false;
+        jassertfalse;
+        allocationsForbidden = true;
+    }
+}
+
+static void* allocate(std::size_t size)
+{
+    checkAllocation();
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+// Over-aligned types get their own operators. The block is over-allocated so
+// it can be aligned by hand, with malloc's pointer stored just in front of it.
+static void* allocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+{
+    checkAllocation();
+
+    auto align = juce::jmax((std::size_t)alignment, sizeof(void*));
+    auto* raw = std::malloc(size + align + sizeof(void*));
+
+    if (raw == nullptr)
+        return nullptr;
+
+    auto address = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + align - 1) & ~(std::uintptr_t)(align - 1);
+    auto* aligned = reinterpret_cast<void*>(address);
+    static_cast<void**>(aligned)[-1] = raw;
+    return aligned;
+}
+
+static void* allocateAlignedOrThrow(std::size_t size, std::align_val_t alignment)
+{
+    if (auto* ptr = allocateAligned(size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+static void freeAligned(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+        std::free(static_cast<void**>(ptr)[-1]);
+}
+
+void* operator new (std::size_t size)                                     { return allocate(size); }
+void* operator new[] (std::size_t size)                                   { return allocate(size); }
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept     { checkAllocation(); return std::malloc(size == 0 ? 1 : size); }
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept   { checkAllocation(); return std::malloc(size == 0 ? 1 : size); }
+
+void operator delete (void* ptr) noexcept                                 { std::free(ptr); }
+void operator delete[] (void* ptr) noexcept                               { std::free(ptr); }
+void operator delete (void* ptr, std::size_t) noexcept                    { std::free(ptr); }
+void operator delete[] (void* ptr, std::size_t) noexcept                  { std::free(ptr); }
+void operator delete (void* ptr, const std::nothrow_t&) noexcept          { std::free(ptr); }
+void operator delete[] (void* ptr, const std::nothrow_t&) noexcept        { std::free(ptr); }
+
+void* operator new (std::size_t size, std::align_val_t alignment)                                     { return allocateAlignedOrThrow(size, alignment); }
+void* operator new[] (std::size_t size, std::align_val_t alignment)                                   { return allocateAlignedOrThrow(size, alignment); }
+void* operator new (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept     { return allocateAligned(size, alignment); }
+void* operator new[] (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept   { return allocateAligned(size, alignment); }
+
+void operator delete (void* ptr, std::align_val_t) noexcept                                   { freeAligned(ptr); }
+void operator delete[] (void* ptr, std::align_val_t) noexcept                                 { freeAligned(ptr); }
+void operator delete (void* ptr, std::size_t, std::align_val_t) noexcept                      { freeAligned(ptr); }
+void operator delete[] (void* ptr, std::size_t, std::align_val_t) noexcept                    { freeAligned(ptr); }
+void operator delete (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept            { freeAligned(ptr); }
+void operator delete[] (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept          { freeAligned(ptr); }
+
+#endif
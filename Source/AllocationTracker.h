@@ -0,0 +1,89 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Allocation Tracker - debug-build check for heap use on the audio thread
+//
+// While a ScopedAllocationGuard is alive, any operator new on the same thread
+// hits a jassert, aligned or not. The global operators are only replaced when
+// CLARITIZER_TRACK_ALLOCATIONS is on (the default for debug builds); release
+// builds get empty guards.
+//
+// juce::HeapBlock, and with it AudioBuffer and Array, calls std::malloc
+// directly, which can't be hooked portably. Buffers like that get a
+// ScopedStorageCheck instead, which asserts that their memory hasn't moved.
+//==============================================================================
+#ifndef CLARITIZER_TRACK_ALLOCATIONS
+ #if JUCE_DEBUG
+  #define CLARITIZER_TRACK_ALLOCATIONS 1
+ #else
+  #define CLARITIZER_TRACK_ALLOCATIONS 0
+ #endif
+#endif
+
+class ScopedAllocationGuard
+{
+public:
+   #if CLARITIZER_TRACK_ALLOCATIONS
+    ScopedAllocationGuard() noexcept;
+    ~ScopedAllocationGuard() noexcept;
+
+private:
+    bool wasForbidden;
+   #else
+    ScopedAllocationGuard() noexcept {}
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedAllocationGuard)
+};
+
+//==============================================================================
+// Asserts when it goes out of scope that a buffer still uses the memory it
+// had when the check was made, i.e. that nothing reallocated it in between
+class ScopedStorageCheck
+{
+public:
+   #if CLARITIZER_TRACK_ALLOCATIONS
+    template <typename SampleType>
+    explicit ScopedStorageCheck(const juce::AudioBuffer<SampleType>& buffer) noexcept
+        : object(&buffer), getStorage(&getAudioBufferStorage<SampleType>), storage(getStorage(object))
+    {
+    }
+
+    template <typename ElementType, bool throwOnFailure>
+    explicit ScopedStorageCheck(const juce::HeapBlock<ElementType, throwOnFailure>& block) noexcept
+        : object(&block), getStorage(&getHeapBlockStorage<ElementType, throwOnFailure>), storage(getStorage(object))
+    {
+    }
+
+    ~ScopedStorageCheck() noexcept
+    {
+        // Something resized this buffer inside processBlock
+        jassert(getStorage(object) == storage);
+    }
+
+private:
+    template <typename SampleType>
+    static const void* getAudioBufferStorage(const void* buffer) noexcept
+    {
+        auto& audio = *static_cast<const juce::AudioBuffer<SampleType>*>(buffer);
+        return audio.getNumChannels() > 0 ? audio.getReadPointer(0) : nullptr;
+    }
+
+    template <typename ElementType, bool throwOnFailure>
+    static const void* getHeapBlockStorage(const void* block) noexcept
+    {
+        return static_cast<const juce::HeapBlock<ElementType, throwOnFailure>*>(block)->get();
+    }
+
+    const void* object;
+    const void* (*getStorage)(const void*);
+    const void* storage;
+   #else
+    template <typename Buffer>
+    explicit ScopedStorageCheck(const Buffer&) noexcept {}
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedStorageCheck)
+};
@@ -0,0 +1,893 @@
+#include "ClaritizerEngine.h"
+
+//==============================================================================
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::prepare(double newSampleRate, int numChannels)
+{
+    jassert(numChannels <= maxChannels);
+
+    sampleRate = newSampleRate;
+    numPreparedChannels = juce::jlimit(1, maxChannels, numChannels);
+
+    // Each line only gets the memory its longest reachable delay needs
+    using Limits = ModeConfigLimits;
+    auto chorusSeconds = (Limits::maxChorusTimeMs * Limits::maxTimeScale + Limits::maxModDepthMs) / 1000.0f;
+    auto delaySeconds = (Limits::maxDelayTimeMs * Limits::maxTimeScale + Limits::maxModDepthMs) / 1000.0f;
+    auto reverbSeconds = (Limits::maxReverbTimeMs * Limits::maxTimeScale + Limits::maxModDepthMs) / 1000.0f;
+
+    float maxDelaySeconds[numLines];
+    maxDelaySeconds[chorusLine] = chorusSeconds;
+    maxDelaySeconds[delay1Line] = delaySeconds;
+    maxDelaySeconds[delay2Line] = delaySeconds;
+
+    for (int i = 0; i < numReverbLines; ++i)
+        maxDelaySeconds[reverbLine1 + i] = reverbSeconds;
+
+    delayBank.prepare(sampleRate, numPreparedChannels, maxDelaySeconds, numLines);
+    delayBank.setFadeLength(juce::roundToInt(sampleRate * delayFadeSeconds));
+    reset();
+}
+
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::reset()
+{
+    delayBank.clear();
+    plan = {};
+
+    for (auto& channelInputs : saturatorInputs)
+        std::fill(std::begin(channelInputs), std::end(channelInputs), 0.0f);
+
+    for (auto& channelState : reverbDampingState)
+        std::fill(std::begin(channelState), std::end(channelState), 0.0f);
+
+    for (auto& channelStates : reverseStates)
+        std::fill(std::begin(channelStates), std::end(channelStates), ReverseState());
+
+    for (auto* modulation : { &chorusModulation, &delay1Modulation, &delay2Modulation, &reverbModulation })
+        modulation->prepare(sampleRate);
+}
+
+//==============================================================================
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::updateBlockParameters(const ModeConfig& config, float timeScale, int numSamples)
+{
+    auto samplesPerMs = (float)sampleRate / 1000.0f;
+
+    // Every channel's line of the same kind has the same capacity
+    auto makeParams = [this, samplesPerMs](int line, float timeMs, float modDepthMs, float feedback)
+    {
+        FeedbackDelayParameters params;
+        params.delay = juce::jlimit(1.0f, delayBank.getLine(0, line).getMaximumDelay(), timeMs * samplesPerMs);
+        params.modDepth = modDepthMs * samplesPerMs;
+        params.feedback = juce::jlimit(0.0f, 0.90f, feedback);
+        return params;
+    };
+
+    blockParams.chorus = makeParams(chorusLine, config.chorus.timeMs * timeScale, config.chorus.modDepth, config.chorus.feedback);
+    blockParams.delay1 = makeParams(delay1Line, config.delay1.baseTimeMs * timeScale, config.delay1.modDepth, config.delay1.feedback);
+    blockParams.delay2 = makeParams(delay2Line, config.delay2.baseTimeMs * timeScale, config.delay2.modDepth, config.delay2.feedback);
+    blockParams.delay1.reverse = config.delay1.reverse;
+    blockParams.delay2.reverse = config.delay2.reverse;
+
+    // A delay switched to reverse starts on a fresh segment
+    for (auto& channelStates : reverseStates)
+    {
+        if (! blockParams.delay1.reverse)  channelStates[0] = {};
+        if (! blockParams.delay2.reverse)  channelStates[1] = {};
+    }
+
+    const float reverbTimes[] = { config.reverb.delay1Time, config.reverb.delay2Time,
+                                  config.reverb.delay3Time, config.reverb.delay4Time };
+    auto meanReverbDelay = 0.0f;
+
+    for (int i = 0; i < numReverbLines; ++i)
+    {
+        blockParams.reverb[i] = makeParams(reverbLine1 + i, reverbTimes[i] * timeScale, config.reverb.modDepth, config.reverb.sharedFeedback);
+        meanReverbDelay += blockParams.reverb[i].delay / (float)numReverbLines;
+    }
+
+    // The feedback and damping are given for a line of average length. Scaling
+    // both by each line's share of it makes every line decay at the same rate,
+    // per second rather than per trip.
+    auto dampingAtNyquist = juce::jlimit(0.0f, 0.95f, config.reverb.damping);
+    auto nyquistGain = (1.0f - dampingAtNyquist) / (1.0f + dampingAtNyquist);
+
+    for (int i = 0; i < numReverbLines; ++i)
+    {
+        auto& reverbParams = blockParams.reverb[i];
+        auto lengthRatio = reverbParams.delay / meanReverbDelay;
+        auto lineNyquistGain = std::pow(nyquistGain, lengthRatio);
+
+        reverbParams.feedback = std::pow(reverbParams.feedback, lengthRatio);
+        blockParams.reverbDampingPole[i] = (1.0f - lineNyquistGain) / (1.0f + lineNyquistGain);
+    }
+
+    blockParams.chorusMix = config.chorus.mix;
+    blockParams.delay1Mix = config.delay1.mix;
+    blockParams.delay2Mix = config.delay2.mix;
+    blockParams.reverbMix = config.reverb.mix;
+
+    updateExecutionPlan(numSamples);
+
+    // Muted modules don't need their LFO either
+    auto depthIfActive = [this](int module, float depth) { return plan.active[(size_t)module] ? depth : 0.0f; };
+
+    chorusModulation.update(config.chorus.modRate, depthIfActive(chorusModule, blockParams.chorus.modDepth), config.chorus.stereoPhase);
+    delay1Modulation.update(config.delay1.modRate, depthIfActive(delay1Module, blockParams.delay1.modDepth), config.delay1.stereoPhase);
+    delay2Modulation.update(config.delay2.modRate, depthIfActive(delay2Module, blockParams.delay2.modDepth), config.delay2.stereoPhase);
+
+    // The reverb lines take the LFO a quarter cycle apart, which needs its cosine
+    reverbModulation.update(config.reverb.modRate, depthIfActive(reverbModule, blockParams.reverb[0].modDepth),
+                            reverbChannelPhaseDegrees, true);
+
+    // Pick each path's interpolator and saturator; the four-tap interpolators
+    // need two samples of delay
+    auto setInterpolator = [this](FeedbackDelayParameters& params, int module, bool modulated)
+    {
+        const auto& choice = interpolation[(size_t)module];
+        params.interpolation = modulated ? choice.modulated : choice.fixed;
+        params.delay = juce::jmax(params.delay, Line::getMinimumDelay(params.interpolation));
+        params.saturation = saturation[(size_t)module];
+    };
+
+    setInterpolator(blockParams.chorus, chorusModule, chorusModulation.active);
+    setInterpolator(blockParams.delay1, delay1Module, delay1Modulation.active);
+    setInterpolator(blockParams.delay2, delay2Module, delay2Modulation.active);
+
+    for (auto& reverbParams : blockParams.reverb)
+        setInterpolator(reverbParams, reverbModule, reverbModulation.active);
+
+    for (int channel = 0; channel < numPreparedChannels; ++channel)
+    {
+        auto setLine = [this, channel](int line, const FeedbackDelayParameters& params)
+        {
+            delayBank.getLine(channel, line).setParameters(params.delay, params.feedback);
+        };
+
+        setLine(chorusLine, blockParams.chorus);
+        setLine(delay1Line, blockParams.delay1);
+        setLine(delay2Line, blockParams.delay2);
+
+        for (int i = 0; i < numReverbLines; ++i)
+            setLine(reverbLine1 + i, blockParams.reverb[i]);
+    }
+}
+
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::updateExecutionPlan(int numSamples)
+{
+    const float mixes[] = { blockParams.chorusMix, blockParams.delay1Mix,
+                            blockParams.delay2Mix, blockParams.reverbMix };
+
+    for (int module = 0; module < numModules; ++module)
+    {
+        auto index = (size_t)module;
+        auto wanted = mixes[module] != 0.0f;
+
+        if (! wanted && plan.active[index])
+        {
+            plan.stale[index] = true;
+            plan.clearedSamples[index] = 0;
+        }
+
+        if (plan.stale[index] && clearModule(module, numSamples * numPreparedChannels * staleClearRate))
+            plan.stale[index] = false;
+
+        plan.active[index] = wanted && ! plan.stale[index];
+    }
+
+    plan.kernel = 0;
+
+    for (int module = 0; module < numModules; ++module)
+        if (plan.active[(size_t)module])
+            plan.kernel |= 1 << module;
+}
+
+// Clears up to maxSamples more of the module's lines, channel by channel, and
+// returns true once all of them are silent
+template <typename SampleType>
+bool ClaritizerEngine<SampleType>::clearModule(int module, int maxSamples)
+{
+    auto firstLine = chorusLine;
+    auto numModuleLines = 1;
+
+    switch (module)
+    {
+        case chorusModule:  firstLine = chorusLine; break;
+        case delay1Module:  firstLine = delay1Line; break;
+        case delay2Module:  firstLine = delay2Line; break;
+        case reverbModule:  firstLine = reverbLine1; numModuleLines = numReverbLines; break;
+        default:            jassertfalse; return true;
+    }
+
+    auto& cleared = plan.clearedSamples[(size_t)module];
+    auto lineStart = 0;
+
+    for (int channel = 0; channel < numPreparedChannels; ++channel)
+    {
+        for (int line = firstLine; line < firstLine + numModuleLines; ++line)
+        {
+            auto delayLine = delayBank.getLine(channel, line);
+            auto capacity = delayLine.getCapacity();
+            auto start = cleared - lineStart;
+            lineStart += capacity;
+
+            if (start >= capacity)
+                continue;
+
+            auto count = juce::jmin(capacity - start, maxSamples);
+            delayLine.clearSamples(start, count);
+            cleared += count;
+            maxSamples -= count;
+
+            if (start + count < capacity)
+                return false;
+
+            delayLine.resetState();
+            saturatorInputs[channel][line] = 0.0f;
+        }
+    }
+
+    if (module == reverbModule)
+        for (auto& channelState : reverbDampingState)
+            std::fill(std::begin(channelState), std::end(channelState), 0.0f);
+
+    return true;
+}
+
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::setInterpolation(Module module, DelayInterpolation modulated, DelayInterpolation fixed)
+{
+    jassert(modulated != DelayInterpolation::allpass);
+    interpolation[(size_t)module] = { modulated, fixed };
+}
+
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::setSaturation(Module module, SaturationMode mode)
+{
+    saturation[(size_t)module] = mode;
+}
+
+template <typename SampleType>
+double ClaritizerEngine<SampleType>::getTailLengthSeconds(const ModeConfig& config, float timeScale)
+{
+    // A loop with feedback g needs log(0.001) / log(g) trips round the line
+    // to fall by 60 dB. Without feedback a path adds no tail at all.
+    auto loopTail = [timeScale](float timeMs, float modDepthMs, float feedback)
+    {
+        feedback = juce::jlimit(0.0f, 0.90f, feedback);
+
+        if (feedback <= 0.0f)
+            return 0.0;
+
+        auto trips = -3.0 / std::log10((double)feedback);
+        return (juce::jmax(timeMs * timeScale, 0.0f) + modDepthMs) * trips / 1000.0;
+    };
+
+    // Chorus, delays and reverb are in series, the two delays in parallel
+    double tail = 0.0;
+
+    if (config.chorus.mix != 0.0f)
+        tail += loopTail(config.chorus.timeMs, config.chorus.modDepth, config.chorus.feedback);
+
+    // A reverse delay reaches back up to three segments for its oldest samples
+    auto delayTail = [&loopTail](const DelayConfig& delay)
+    {
+        if (delay.mix == 0.0f)
+            return 0.0;
+
+        return loopTail(delay.baseTimeMs * (delay.reverse ? 3.0f : 1.0f), delay.modDepth, delay.feedback);
+    };
+
+    tail += juce::jmax(delayTail(config.delay1), delayTail(config.delay2));
+
+    // Every reverb line decays like one of average length, after the longest
+    // line has delivered its first echo
+    if (config.reverb.mix != 0.0f)
+    {
+        auto longestMs = 0.0f, meanMs = 0.0f;
+
+        for (auto timeMs : { config.reverb.delay1Time, config.reverb.delay2Time,
+                             config.reverb.delay3Time, config.reverb.delay4Time })
+        {
+            longestMs = juce::jmax(longestMs, timeMs);
+            meanMs += timeMs / (float)numReverbLines;
+        }
+
+        tail += (juce::jmax(longestMs * timeScale, 0.0f) + config.reverb.modDepth) / 1000.0;
+        tail += loopTail(meanMs, 0.0f, config.reverb.sharedFeedback);
+    }
+
+    return tail;
+}
+
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::process(SampleType* const* channelData, int numChannels, int numSamples,
+                                           const ModeConfig& config, float timeScale)
+{
+    updateBlockParameters(config, timeScale, numSamples);
+
+    numChannels = juce::jmin(numChannels, numPreparedChannels);
+    auto kernel = channelKernels[(size_t)plan.kernel];
+
+    for (int offset = 0; offset < numSamples; offset += subBlockSize)
+    {
+        auto blockSize = juce::jmin(subBlockSize, numSamples - offset);
+
+        for (auto* modulation : { &chorusModulation, &delay1Modulation, &delay2Modulation, &reverbModulation })
+            modulation->generate(blockSize);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            // Work on an aligned copy so every module can use aligned vector loads
+            auto* data = channelData[channel] + offset;
+            juce::FloatVectorOperations::copy(channelBlock, data, blockSize);
+            (this->*kernel)(channel, channelBlock, blockSize);
+            juce::FloatVectorOperations::copy(data, channelBlock, blockSize);
+        }
+    }
+}
+
+//==============================================================================
+// Channel kernels, one per combination of active modules
+//==============================================================================
+template <typename SampleType>
+template <size_t... activeModules>
+std::array<typename ClaritizerEngine<SampleType>::ChannelKernel, ClaritizerEngine<SampleType>::numKernels>
+ClaritizerEngine<SampleType>::makeChannelKernels(std::index_sequence<activeModules...>)
+{
+    return { { &ClaritizerEngine::processChannel<(int)activeModules>... } };
+}
+
+template <typename SampleType>
+const std::array<typename ClaritizerEngine<SampleType>::ChannelKernel, ClaritizerEngine<SampleType>::numKernels>
+ClaritizerEngine<SampleType>::channelKernels = makeChannelKernels(std::make_index_sequence<numKernels>());
+
+template <typename SampleType>
+template <int activeModules>
+void ClaritizerEngine<SampleType>::processChannel(int channel, SampleType* data, int numSamples)
+{
+    constexpr auto isActive = [](int module) { return (activeModules & (1 << module)) != 0; };
+
+    // A muted module leaves the signal untouched, except for the delays which
+    // replace it with their sum
+    if constexpr (isActive(chorusModule))
+    {
+        ScopedStageTimer timer(profiler, StageProfiler::chorusStage);
+        processChorus(channel, data, numSamples);
+    }
+
+    {
+        ScopedStageTimer timer(profiler, StageProfiler::delaysStage);
+        processDelays<isActive(delay1Module), isActive(delay2Module)>(channel, data, numSamples);
+    }
+
+    if constexpr (isActive(reverbModule))
+    {
+        ScopedStageTimer timer(profiler, StageProfiler::reverbStage);
+        processReverb(channel, data, numSamples);
+    }
+}
+
+//==============================================================================
+// CHORUS MODULE (series, pre)
+//==============================================================================
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::processChorus(int channel, SampleType* data, int numSamples)
+{
+    processFeedbackDelay(channel, chorusLine, &chorusModulation, blockParams.chorus,
+                         data, moduleOutput, numSamples);
+
+    mixWet(data, moduleOutput, blockParams.chorusMix, numSamples);
+}
+
+//==============================================================================
+// PARALLEL DELAYS (Delay 1 & 2)
+//==============================================================================
+template <typename SampleType>
+template <bool delay1Active, bool delay2Active>
+void ClaritizerEngine<SampleType>::processDelays(int channel, SampleType* data, int numSamples)
+{
+    if constexpr (delay1Active)
+        processFeedbackDelay(channel, delay1Line, &delay1Modulation, blockParams.delay1,
+                             data, moduleOutput, numSamples);
+
+    if constexpr (delay2Active)
+        processFeedbackDelay(channel, delay2Line, &delay2Modulation, blockParams.delay2,
+                             data, secondModuleOutput, numSamples);
+
+    // Sum parallel delays
+    if constexpr (delay1Active)
+        juce::FloatVectorOperations::copyWithMultiply(data, moduleOutput, blockParams.delay1Mix, numSamples);
+    else
+        juce::FloatVectorOperations::clear(data, numSamples);
+
+    if constexpr (delay2Active)
+        juce::FloatVectorOperations::addWithMultiply(data, secondModuleOutput, blockParams.delay2Mix, numSamples);
+}
+
+//==============================================================================
+// REVERB MODULE (feedback delay network, post)
+//
+// Each line is fed the input plus the damped outputs of all four, mixed by a
+// Householder reflection:
+//
+//     in[i] = x / 2 + g[i] * (d[i] - sum(d) / 2)
+//
+// The reflection is lossless, so the per-line gains alone set the decay. The
+// lines are read and written a chunk at a time; in between, every sample runs
+// the four lines' damping, mixing and gains side by side in SIMD lanes: one
+// register in float, two in double.
+//==============================================================================
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::processReverb(int channel, SampleType* data, int numSamples)
+{
+    // Neighbouring channels tap the lines with different signs and follow the
+    // LFO at different phases, so the outputs decorrelate
+    static constexpr SampleType outputGains[numReverbLines][numReverbLines] = { { 0.5, -0.5,  0.5, -0.5 },
+                                                                                { 0.5,  0.5, -0.5, -0.5 },
+                                                                                { 0.5, -0.5, -0.5,  0.5 },
+                                                                                { 0.5,  0.5,  0.5,  0.5 } };
+
+    // The lines follow the LFO a quarter cycle apart from the channel's own
+    // phase, so they never all stretch together
+    auto channelCos = reverbModulation.offsetCos[(size_t)channel];
+    auto channelSin = reverbModulation.offsetSin[(size_t)channel];
+    const float lineOffsetCos[numReverbLines] = { channelCos, -channelSin, -channelCos, channelSin };
+    const float lineOffsetSin[numReverbLines] = { channelSin, channelCos, -channelSin, -channelCos };
+
+    Line lines[numReverbLines];
+    ReadPlan readPlans[numReverbLines];
+    SampleType gains[numReverbLines];
+    auto chunkSize = numSamples;
+
+    for (int i = 0; i < numReverbLines; ++i)
+    {
+        lines[i] = delayBank.getLine(channel, reverbLine1 + i);
+        lines[i].beginBlock();
+        gains[i] = (SampleType)lines[i].getFeedback();
+
+        readPlans[i] = planReads(lines[i], &reverbModulation, lineOffsetCos[i], lineOffsetSin[i], blockParams.reverb[i],
+                                 reverbDelayTimes[i], reverbPreviousDelayTimes[i], numSamples);
+        chunkSize = juce::jmin(chunkSize, readPlans[i].maxChunkSize);
+    }
+
+    const auto* poles = blockParams.reverbDampingPole;
+    const auto* taps = outputGains[channel % numReverbLines];
+    auto* dampingState = reverbDampingState[channel];
+
+    // The four lines fill one register in float and two in double. Registers
+    // wider than that fall back to running the lines one after the other.
+    constexpr int numLineVectors = numReverbLines / vectorSize;
+    constexpr bool linesFillVectors = numLineVectors > 0 && numReverbLines % vectorSize == 0;
+
+    alignas(vectorAlignment) SampleType poleLanes[numReverbLines];
+    alignas(vectorAlignment) SampleType gainLanes[numReverbLines];
+    alignas(vectorAlignment) SampleType tapLanes[numReverbLines];
+    alignas(vectorAlignment) SampleType damping[numReverbLines];
+    alignas(vectorAlignment) SampleType delayed[numReverbLines];
+    alignas(vectorAlignment) SampleType lineInputs[numReverbLines];
+
+    for (int i = 0; i < numReverbLines; ++i)
+    {
+        poleLanes[i] = (SampleType)poles[i];
+        gainLanes[i] = gains[i];
+        tapLanes[i] = taps[i];
+        damping[i] = dampingState[i];
+    }
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        auto length = juce::jmin(chunkSize, numSamples - start);
+
+        for (int i = 0; i < numReverbLines; ++i)
+            readChunk(lines[i], readPlans[i], reverbTaps[i], start, length);
+
+        if constexpr (linesFillVectors)
+        {
+            SampleVector poleVectors[numLineVectors], gainVectors[numLineVectors];
+            SampleVector tapVectors[numLineVectors], dampingVectors[numLineVectors];
+
+            for (int v = 0; v < numLineVectors; ++v)
+            {
+                poleVectors[v] = SampleVector::fromRawArray(poleLanes + v * vectorSize);
+                gainVectors[v] = SampleVector::fromRawArray(gainLanes + v * vectorSize);
+                tapVectors[v] = SampleVector::fromRawArray(tapLanes + v * vectorSize);
+                dampingVectors[v] = SampleVector::fromRawArray(damping + v * vectorSize);
+            }
+
+            for (int n = start; n < start + length; ++n)
+            {
+                for (int i = 0; i < numReverbLines; ++i)
+                    delayed[i] = reverbTaps[i][n];
+
+                // One-pole low-pass in every line, then the reflection and the
+                // wet taps as sums across the lanes
+                auto dampingSum = SampleVector::expand(0);
+                auto wetSum = SampleVector::expand(0);
+
+                for (int v = 0; v < numLineVectors; ++v)
+                {
+                    auto delayedVector = SampleVector::fromRawArray(delayed + v * vectorSize);
+                    dampingVectors[v] = SampleVector::multiplyAdd(delayedVector, poleVectors[v], dampingVectors[v] - delayedVector);
+                    dampingSum += dampingVectors[v];
+                    wetSum = SampleVector::multiplyAdd(wetSum, tapVectors[v], delayedVector);
+                }
+
+                auto reflection = SampleVector::expand((SampleType)0.5 * dampingSum.sum());
+                auto input = SampleVector::expand((SampleType)0.5 * data[n]);
+
+                for (int v = 0; v < numLineVectors; ++v)
+                    SampleVector::multiplyAdd(input, gainVectors[v], dampingVectors[v] - reflection)
+                        .copyToRawArray(lineInputs + v * vectorSize);
+
+                for (int i = 0; i < numReverbLines; ++i)
+                    reverbLineInputs[i][n] = lineInputs[i];
+
+                moduleOutput[n] = wetSum.sum();
+            }
+
+            for (int v = 0; v < numLineVectors; ++v)
+                dampingVectors[v].copyToRawArray(damping + v * vectorSize);
+        }
+        else
+        {
+            for (int n = start; n < start + length; ++n)
+            {
+                for (int i = 0; i < numReverbLines; ++i)
+                    delayed[i] = reverbTaps[i][n];
+
+                // One-pole low-pass in every line
+                for (int i = 0; i < numReverbLines; ++i)
+                    damping[i] = delayed[i] + poleLanes[i] * (damping[i] - delayed[i]);
+
+                auto reflection = (SampleType)0.5 * (damping[0] + damping[1] + damping[2] + damping[3]);
+                auto input = (SampleType)0.5 * data[n];
+                SampleType wet = 0;
+
+                for (int i = 0; i < numReverbLines; ++i)
+                {
+                    reverbLineInputs[i][n] = input + gainLanes[i] * (damping[i] - reflection);
+                    wet += tapLanes[i] * delayed[i];
+                }
+
+                moduleOutput[n] = wet;
+            }
+        }
+
+        for (int i = 0; i < numReverbLines; ++i)
+        {
+            auto* lineInput = reverbLineInputs[i] + start;
+            saturate(lineInput, length, blockParams.reverb[i].saturation, saturatorInputs[channel][reverbLine1 + i]);
+            lines[i].write(lineInput, length);
+        }
+    }
+
+    std::copy(damping, damping + numReverbLines, dampingState);
+
+    // Mix reverb with dry parallel sum
+    mixWet(data, moduleOutput, blockParams.reverbMix, numSamples);
+}
+
+//==============================================================================
+// Reads the delayed signal, adds it back with feedback, clips and writes the
+// result into the line. The block is split into chunks no longer than the
+// shortest delay so every read only sees samples written by earlier chunks;
+// chunks are whole vectors wherever the delay allows it.
+//==============================================================================
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::processFeedbackDelay(int channel, int lineIndex, const Modulation* modulation,
+                                                        const FeedbackDelayParameters& params,
+                                                        const SampleType* input, SampleType* output, int numSamples)
+{
+    auto line = delayBank.getLine(channel, lineIndex);
+    auto& saturatorInput = saturatorInputs[channel][lineIndex];
+
+    line.beginBlock();
+
+    if (line.getFeedback() == 0.0f)
+    {
+        // Nothing is read back, the line only has to keep recording
+        line.finishFade();
+
+        if (output != input)
+            juce::FloatVectorOperations::copy(output, input, numSamples);
+
+        saturate(output, numSamples, params.saturation, saturatorInput);
+        line.write(output, numSamples);
+        return;
+    }
+
+    if (params.reverse)
+    {
+        jassert(lineIndex == delay1Line || lineIndex == delay2Line);
+
+        // The reverse heads don't use the forward head's crossfade
+        line.finishFade();
+        processReverseDelay(line, reverseStates[channel][lineIndex - delay1Line], saturatorInput, params,
+                            input, output, numSamples);
+        return;
+    }
+
+    auto offsetCos = modulation != nullptr ? modulation->offsetCos[(size_t)channel] : 1.0f;
+    auto offsetSin = modulation != nullptr ? modulation->offsetSin[(size_t)channel] : 0.0f;
+    auto readPlan = planReads(line, modulation, offsetCos, offsetSin, params,
+                              delayTimes, previousDelayTimes, numSamples);
+    auto chunkSize = readPlan.maxChunkSize;
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        auto length = juce::jmin(chunkSize, numSamples - start);
+
+        readChunk(line, readPlan, delayedSamples, start, length);
+        mixFeedback(input + start, delayedSamples + start, line.getFeedback(), output + start, length);
+        saturate(output + start, length, params.saturation, saturatorInput);
+
+        line.write(output + start, length);
+    }
+}
+
+// Call after beginBlock(). The modulation is shifted by the given phase offset:
+// sin(phase + offset) = sin(phase) cos(offset) + cos(phase) sin(offset)
+template <typename SampleType>
+typename ClaritizerEngine<SampleType>::ReadPlan
+ClaritizerEngine<SampleType>::planReads(Line& line, const Modulation* modulation,
+                                        float offsetCos, float offsetSin,
+                                        const FeedbackDelayParameters& params,
+                                        SampleType* delayTimesScratch, SampleType* previousDelayTimesScratch,
+                                        int numSamples)
+{
+    ReadPlan readPlan;
+    readPlan.interpolation = params.interpolation;
+    readPlan.modulated = modulation != nullptr && modulation->active;
+
+    auto minimumDelay = Line::getMinimumDelay(readPlan.interpolation);
+    readPlan.delay = juce::jmax(line.getDelay(), minimumDelay);
+    readPlan.previousDelay = juce::jmax(line.getPreviousDelay(), minimumDelay);
+
+    // The allpass keeps one state per line, so a head being faded out is read linearly
+    readPlan.previousInterpolation = readPlan.interpolation == DelayInterpolation::allpass ? DelayInterpolation::linear
+                                                                                         : readPlan.interpolation;
+    auto fading = line.isFading();
+    auto shortestDelay = fading ? juce::jmin(readPlan.delay, readPlan.previousDelay) : readPlan.delay;
+
+    if (readPlan.modulated)
+    {
+        auto maxDelay = line.getMaximumDelay();
+
+        juce::FloatVectorOperations::copyWithMultiply(delayTimesScratch, modulation->sine, params.modDepth * offsetCos, numSamples);
+
+        if (offsetSin != 0.0f)
+            juce::FloatVectorOperations::addWithMultiply(delayTimesScratch, modulation->cosine, params.modDepth * offsetSin, numSamples);
+
+        // The old head keeps the same modulation around its own delay
+        if (fading)
+        {
+            juce::FloatVectorOperations::add(previousDelayTimesScratch, delayTimesScratch, readPlan.previousDelay, numSamples);
+            juce::FloatVectorOperations::clip(previousDelayTimesScratch, previousDelayTimesScratch, minimumDelay, maxDelay, numSamples);
+        }
+
+        juce::FloatVectorOperations::add(delayTimesScratch, readPlan.delay, numSamples);
+        juce::FloatVectorOperations::clip(delayTimesScratch, delayTimesScratch, minimumDelay, maxDelay, numSamples);
+        shortestDelay = (float)juce::FloatVectorOperations::findMinimum(delayTimesScratch, numSamples);
+
+        if (fading)
+            shortestDelay = juce::jmin(shortestDelay, (float)juce::FloatVectorOperations::findMinimum(previousDelayTimesScratch, numSamples));
+
+        readPlan.delayTimes = delayTimesScratch;
+        readPlan.previousDelayTimes = previousDelayTimesScratch;
+    }
+
+    // Four-tap and allpass reads look one sample newer than the delay
+    auto chunkSize = (int)shortestDelay - (int)(minimumDelay - 1.0f);
+
+    if (chunkSize >= vectorSize)
+        chunkSize -= chunkSize % vectorSize;
+
+    readPlan.maxChunkSize = juce::jlimit(1, numSamples, chunkSize);
+    return readPlan;
+}
+
+// Reads samples [start, start + length) of the block into output, crossfading
+// from the old read head while a delay change is in progress
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::readChunk(Line& line, const ReadPlan& readPlan, SampleType* output, int start, int length)
+{
+    if (readPlan.modulated)
+        line.readModulated(readPlan.delayTimes + start, output + start, length, readPlan.interpolation);
+    else
+        line.read(readPlan.delay, output + start, length, readPlan.interpolation);
+
+    if (line.isFading())
+    {
+        if (readPlan.modulated)
+            line.readModulated(readPlan.previousDelayTimes + start, previousHeadSamples + start, length, readPlan.previousInterpolation);
+        else
+            line.read(readPlan.previousDelay, previousHeadSamples + start, length, readPlan.previousInterpolation);
+
+        line.applyFade(previousHeadSamples + start, output + start, length);
+    }
+}
+
+//==============================================================================
+// Reverse delay. The line keeps recording forwards while a read head walks
+// backwards through it, one delay-length segment at a time. At position p of
+// a segment the head reads 2p + 1 samples back, i.e. the segment that just
+// ended plays from its last sample to its first. For the first few ms of each
+// segment the previous head, still walking back past the start of its own
+// segment, fades out. It carries on from where it stopped, so it goes by the
+// length of the segment it played rather than the one just latched.
+//
+// Every read is older than the block, so chunks only break where the fade or
+// the segment ends, and the cost is one read per sample like a forward delay.
+//==============================================================================
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::processReverseDelay(Line line, ReverseState& reverse, SampleType& saturatorInput,
+                                                       const FeedbackDelayParameters& params,
+                                                       const SampleType* input, SampleType* output, int numSamples)
+{
+    auto feedback = line.getFeedback();
+
+    for (int start = 0; start < numSamples;)
+    {
+        if (reverse.position == 0)
+        {
+            // The fading head reaches back up to three segments
+            auto maxSegmentLength = juce::jmax(2, (int)line.getMaximumDelay() / 3);
+            auto previousSegmentLength = reverse.segmentLength;
+            reverse.segmentLength = juce::jlimit(2, maxSegmentLength, juce::roundToInt(params.delay));
+
+            // The first segment fades in from a head as far back as its own length
+            reverse.previousSegmentLength = previousSegmentLength > 0 ? previousSegmentLength
+                                                                      : reverse.segmentLength;
+            reverse.fadeLength = juce::jlimit(1, reverse.segmentLength / 2, juce::roundToInt(sampleRate * reverseFadeSeconds));
+        }
+
+        auto position = reverse.position;
+        auto segmentLength = reverse.segmentLength;
+        auto fadeLength = reverse.fadeLength;
+        auto fading = position < fadeLength;
+
+        auto length = juce::jmin(numSamples - start, (fading ? fadeLength : segmentLength) - position);
+        auto* delayed = delayedSamples + start;
+
+        line.readReverse(2 * position, delayed, length);
+
+        if (fading)
+        {
+            auto* previousHead = previousHeadSamples + start;
+            line.readReverse(2 * (position + reverse.previousSegmentLength), previousHead, length);
+
+            auto step = (SampleType)1 / (SampleType)fadeLength;
+
+            for (int i = 0; i < length; ++i)
+            {
+                auto gain = (SampleType)(position + i) * step;
+                delayed[i] = previousHead[i] + gain * (delayed[i] - previousHead[i]);
+            }
+        }
+
+        mixFeedback(input + start, delayed, feedback, output + start, length);
+        saturate(output + start, length, params.saturation, saturatorInput);
+        line.write(output + start, length);
+
+        reverse.position = (position + length) % segmentLength;
+        start += length;
+    }
+}
+
+//==============================================================================
+// Modulation
+//==============================================================================
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::Modulation::prepare(double sampleRate)
+{
+    lfo.prepare(sampleRate);
+    active = false;
+    quadrature = false;
+    offsetDegrees = 0.0f;
+    offsetCos.fill(1.0f);
+    offsetSin.fill(0.0f);
+}
+
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::Modulation::update(float rateHz, float depth, float stereoPhaseDegrees, bool needsQuadrature)
+{
+    lfo.setFrequency(rateHz);
+
+    // A stopped LFO is treated as resting at phase zero, where it adds nothing
+    active = depth != 0.0f && lfo.isRunning();
+    quadrature = active && (needsQuadrature || stereoPhaseDegrees != 0.0f);
+
+    // The phase only moves with the parameter, so most blocks reuse the offsets
+    auto newOffsetDegrees = quadrature ? stereoPhaseDegrees : 0.0f;
+
+    if (newOffsetDegrees == offsetDegrees)
+        return;
+
+    offsetDegrees = newOffsetDegrees;
+
+    for (size_t channel = 0; channel < maxChannels; ++channel)
+    {
+        auto offset = juce::degreesToRadians(offsetDegrees) * (float)channel;
+        offsetCos[channel] = std::cos(offset);
+        offsetSin[channel] = std::sin(offset);
+    }
+}
+
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::Modulation::generate(int numSamples)
+{
+    if (active)
+        lfo.fill(sine, quadrature ? cosine : nullptr, numSamples);
+}
+
+//==============================================================================
+// data = data * (1 - mix) + wet * mix. Fully wet modules are a plain copy.
+//==============================================================================
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::mixWet(SampleType* data, const SampleType* wet, float mix, int numSamples)
+{
+    if (mix == 1.0f)
+    {
+        juce::FloatVectorOperations::copy(data, wet, numSamples);
+        return;
+    }
+
+    juce::FloatVectorOperations::multiply(data, 1.0f - mix, numSamples);
+    juce::FloatVectorOperations::addWithMultiply(data, wet, mix, numSamples);
+}
+
+//==============================================================================
+// output = input + delayed * feedback, several samples per instruction
+//==============================================================================
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::mixFeedback(const SampleType* input, const SampleType* delayed, SampleType feedback,
+                                               SampleType* output, int numSamples)
+{
+    int i = 0;
+
+    if (SampleVector::isSIMDAligned(input)
+     && SampleVector::isSIMDAligned(delayed)
+     && SampleVector::isSIMDAligned(output))
+    {
+        auto feedbackVector = SampleVector::expand(feedback);
+
+        for (; i + vectorSize <= numSamples; i += vectorSize)
+            SampleVector::multiplyAdd(SampleVector::fromRawArray(input + i),
+                                      SampleVector::fromRawArray(delayed + i),
+                                      feedbackVector).copyToRawArray(output + i);
+    }
+
+    for (; i < numSamples; ++i)
+        output[i] = input[i] + delayed[i] * feedback;
+}
+
+// Below the knee either saturator is the identity, so quiet chunks skip it.
+// The anti-aliased one also looks back one sample, which has to be quiet too.
+template <typename SampleType>
+void ClaritizerEngine<SampleType>::saturate(SampleType* data, int numSamples, SaturationMode mode, SampleType& previousInput)
+{
+    auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+    auto quiet = range.getStart() >= -SoftClip::knee && range.getEnd() <= SoftClip::knee;
+
+    if (mode == SaturationMode::softClip)
+    {
+        // Kept up to date so switching modes never differentiates across a gap
+        previousInput = data[numSamples - 1];
+
+        if (! quiet)
+            SoftClip::process(data, numSamples);
+
+        return;
+    }
+
+    if (quiet && std::abs(previousInput) <= SoftClip::knee)
+        previousInput = data[numSamples - 1];
+    else
+        AntialiasedSoftClip::process(data, numSamples, previousInput);
+}
+
+//==============================================================================
+template class ClaritizerEngine<float>;
+template class ClaritizerEngine<double>;
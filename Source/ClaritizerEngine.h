@@ -0,0 +1,263 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ModeConfig.h"
+#include "DelayBank.h"
+#include "SimpleLFO.h"
+#include "SoftClip.h"
+#include "StageProfiler.h"
+
+//==============================================================================
+// Claritizer Engine - chorus -> parallel delays -> reverb, processed block-wise
+//
+// The reverb is a four-line feedback delay network: the lines are mixed by a
+// Householder matrix, damped and modulated, with all four handled side by side
+// in SIMD lanes each sample: one register in float, two in double.
+//
+// Every channel has its own lines and state, from mono up to 7.1.4. Channels
+// are independent, so each one runs the vectorised path on its own.
+//
+// Each module runs over a whole sub-block of one channel before the next module
+// starts. Everything that only depends on the mode config, the TIME knob and the
+// sample rate is worked out once per host block; only the feedback path itself
+// stays serial. Which modules run is fixed for the block too, so each channel
+// goes through one of sixteen kernels compiled for exactly that combination,
+// picked from a table once per block.
+//
+// Inside a feedback chunk the samples no longer depend on each other, so the
+// feedback mix runs across SIMD lanes of consecutive samples. All scratch
+// buffers are SIMD-aligned and chunk boundaries are kept on whole vectors.
+//
+// The engine runs in float or double. Only the audio path takes the sample
+// type; delay settings, gains and LFO offsets stay float either way. Both
+// versions are instantiated in ClaritizerEngine.cpp.
+//==============================================================================
+template <typename SampleType>
+class ClaritizerEngine
+{
+public:
+    static constexpr int maxChannels = 12;     // 7.1.4
+    static constexpr int subBlockSize = 256;
+
+    enum Module
+    {
+        chorusModule,
+        delay1Module,
+        delay2Module,
+        reverbModule,
+        numModules
+    };
+
+    // Delay memory is sized for numChannels channels at sampleRate. An
+    // oversampled engine is prepared at the oversampled rate.
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    // Runs the wet chain in place on up to the prepared number of channels
+    void process(SampleType* const* channelData, int numChannels, int numSamples,
+                 const ModeConfig& config, float timeScale);
+
+    // How long the wet chain keeps ringing after its input stops, taken as
+    // the time for every feedback loop that's audible to decay by 60 dB
+    static double getTailLengthSeconds(const ModeConfig& config, float timeScale);
+
+    // Interpolation a module uses while its LFO moves the delay and while the
+    // delay is fixed. The allpass only works for fixed delays.
+    void setInterpolation(Module module, DelayInterpolation modulated, DelayInterpolation fixed);
+
+    // Saturator inside a module's feedback loops. The anti-aliased one costs
+    // more per clipping sample but keeps hot loops clean without oversampling.
+    void setSaturation(Module module, SaturationMode mode);
+
+    // Times the chorus, delays and reverb of every channel into profiler,
+    // or nothing when it's null
+    void setProfiler(StageProfiler* newProfiler) noexcept    { profiler = newProfiler; }
+
+private:
+    // Per-block timing of one feedback delay, all in samples. The delay and
+    // feedback are also copied into each line's hot state.
+    struct FeedbackDelayParameters
+    {
+        float delay = 1.0f;
+        float modDepth = 0.0f;
+        float feedback = 0.0f;
+        DelayInterpolation interpolation = DelayInterpolation::linear;
+        SaturationMode saturation = SaturationMode::softClip;
+        bool reverse = false;
+    };
+
+    struct InterpolationChoice
+    {
+        DelayInterpolation modulated = DelayInterpolation::hermite;
+        DelayInterpolation fixed = DelayInterpolation::allpass;
+    };
+
+    static constexpr int numReverbLines = 4;
+
+    struct BlockParameters
+    {
+        FeedbackDelayParameters chorus, delay1, delay2;
+        FeedbackDelayParameters reverb[numReverbLines];
+        float reverbDampingPole[numReverbLines] {};     // One-pole low-pass in each reverb line
+        float chorusMix = 0.0f;
+        float delay1Mix = 0.0f;
+        float delay2Mix = 0.0f;
+        float reverbMix = 0.0f;
+    };
+
+    // Line order within each channel of the delay bank
+    enum LineIndex
+    {
+        chorusLine,
+        delay1Line,
+        delay2Line,
+        reverbLine1,
+        numLines = reverbLine1 + numReverbLines
+    };
+
+    // Which modules run this block. A module whose mix is zero is skipped
+    // outright; its lines are marked stale and cleared a slice per block while
+    // it stays muted, so re-enabling it never replays an old tail. A module
+    // whose mix comes back before that's done waits until its lines are silent.
+    struct ExecutionPlan
+    {
+        std::array<bool, numModules> active {};
+        std::array<bool, numModules> stale {};
+        std::array<int, numModules> clearedSamples {};  // Progress through a stale module's lines
+        int kernel = 0;             // Index into channelKernels, one bit per active module
+    };
+
+    // A channel's whole chain with the set of active modules fixed at compile
+    // time, so skipped modules and their branches vanish from the kernel
+    using ChannelKernel = void (ClaritizerEngine::*)(int channel, SampleType* data, int numSamples);
+    static constexpr int numKernels = 1 << numModules;
+
+    template <size_t... activeModules>
+    static std::array<ChannelKernel, numKernels> makeChannelKernels(std::index_sequence<activeModules...>);
+    static const std::array<ChannelKernel, numKernels> channelKernels;
+
+    // Phase step between the reverb modulation of neighbouring channels
+    static constexpr float reverbChannelPhaseDegrees = 360.0f / (float)maxChannels;
+
+    // Samples of a stale module's lines cleared per sample and channel
+    // processed: the longest delay lines are silent again within 0.2 s, in
+    // slices no bigger than the block's own work
+    static constexpr int staleClearRate = 64;
+
+    // Delay changes crossfade between read heads over this long
+    static constexpr double delayFadeSeconds = 0.02;
+
+    // Reverse segments crossfade into each other over this long
+    static constexpr double reverseFadeSeconds = 0.01;
+
+    // Where a reverse delay is within its current segment. The lengths are
+    // latched at the start of every segment, so the delay time can move freely.
+    struct ReverseState
+    {
+        int position = 0;
+        int segmentLength = 0;      // 0 until the first segment starts
+        int previousSegmentLength = 0;  // Of the segment the fading head finishes
+        int fadeLength = 0;
+    };
+
+    using SampleVector = juce::dsp::SIMDRegister<SampleType>;
+    static constexpr int vectorSize = (int)SampleVector::SIMDNumElements;
+    static constexpr size_t vectorAlignment = SampleVector::SIMDRegisterSize;
+
+    using Line = DelayLine<SampleType>;
+
+    // One LFO per module, shared by every channel. Each channel is shifted in
+    // phase by the stereo offset more than the one before, by mixing the sine
+    // with its quadrature partner, so the offsets cost no extra oscillator.
+    struct Modulation
+    {
+        SimpleLFO<SampleType> lfo;
+        bool active = false;        // False when the depth or the rate is zero
+        bool quadrature = false;    // True when any channel has a phase offset
+        std::array<float, maxChannels> offsetCos {}, offsetSin {};
+        float offsetDegrees = 0.0f;     // Per-channel step the offsets were worked out for
+
+        alignas(vectorAlignment) SampleType sine[subBlockSize];
+        alignas(vectorAlignment) SampleType cosine[subBlockSize];
+
+        void prepare(double sampleRate);
+        void update(float rateHz, float depth, float stereoPhaseDegrees, bool needsQuadrature = false);
+        void generate(int numSamples);
+    };
+
+    // Where one line reads from during a block, worked out before the chunk
+    // loop. Modulated delays are written into the caller's scratch.
+    struct ReadPlan
+    {
+        bool modulated = false;
+        float delay = 1.0f, previousDelay = 1.0f;
+        DelayInterpolation interpolation = DelayInterpolation::linear;
+        DelayInterpolation previousInterpolation = DelayInterpolation::linear;
+        const SampleType* delayTimes = nullptr;
+        const SampleType* previousDelayTimes = nullptr;
+        int maxChunkSize = 1;       // Longest chunk whose reads only see earlier chunks
+    };
+
+    void updateBlockParameters(const ModeConfig& config, float timeScale, int numSamples);
+    void updateExecutionPlan(int numSamples);
+    bool clearModule(int module, int maxSamples);
+
+    template <int activeModules>
+    void processChannel(int channel, SampleType* data, int numSamples);
+    void processChorus(int channel, SampleType* data, int numSamples);
+    template <bool delay1Active, bool delay2Active>
+    void processDelays(int channel, SampleType* data, int numSamples);
+    void processReverb(int channel, SampleType* data, int numSamples);
+
+    void processFeedbackDelay(int channel, int lineIndex, const Modulation* modulation,
+                              const FeedbackDelayParameters& params,
+                              const SampleType* input, SampleType* output, int numSamples);
+
+    static ReadPlan planReads(Line& line, const Modulation* modulation, float offsetCos, float offsetSin,
+                              const FeedbackDelayParameters& params, SampleType* delayTimesScratch,
+                              SampleType* previousDelayTimesScratch, int numSamples);
+    void readChunk(Line& line, const ReadPlan& readPlan, SampleType* output, int start, int length);
+
+    void processReverseDelay(Line line, ReverseState& reverse, SampleType& saturatorInput,
+                             const FeedbackDelayParameters& params,
+                             const SampleType* input, SampleType* output, int numSamples);
+
+    static void mixWet(SampleType* data, const SampleType* wet, float mix, int numSamples);
+    static void mixFeedback(const SampleType* input, const SampleType* delayed, SampleType feedback,
+                            SampleType* output, int numSamples);
+    static void saturate(SampleType* data, int numSamples, SaturationMode mode, SampleType& previousInput);
+
+    double sampleRate = 44100.0;
+    int numPreparedChannels = 0;
+    DelayBank<SampleType> delayBank;
+    Modulation chorusModulation, delay1Modulation, delay2Modulation, reverbModulation;
+    BlockParameters blockParams;
+    ExecutionPlan plan;
+    StageProfiler* profiler = nullptr;
+    std::array<InterpolationChoice, numModules> interpolation;
+    std::array<SaturationMode, numModules> saturation {};
+
+    // Last saturator input of every line, for the anti-aliased saturator
+    SampleType saturatorInputs[maxChannels][numLines] {};
+
+    // Damping filter state of every reverb line
+    SampleType reverbDampingState[maxChannels][numReverbLines] {};
+
+    // Segment progress of the two delays, used while they play in reverse
+    ReverseState reverseStates[maxChannels][2];
+
+    // Scratch for one sub-block
+    alignas(vectorAlignment) SampleType channelBlock[subBlockSize];
+    alignas(vectorAlignment) SampleType delayTimes[subBlockSize];
+    alignas(vectorAlignment) SampleType delayedSamples[subBlockSize];
+    alignas(vectorAlignment) SampleType previousDelayTimes[subBlockSize];
+    alignas(vectorAlignment) SampleType previousHeadSamples[subBlockSize];
+    alignas(vectorAlignment) SampleType moduleOutput[subBlockSize];
+    alignas(vectorAlignment) SampleType secondModuleOutput[subBlockSize];
+
+    // Reverb scratch, one row per line
+    alignas(vectorAlignment) SampleType reverbDelayTimes[numReverbLines][subBlockSize];
+    alignas(vectorAlignment) SampleType reverbPreviousDelayTimes[numReverbLines][subBlockSize];
+    alignas(vectorAlignment) SampleType reverbTaps[numReverbLines][subBlockSize];
+    alignas(vectorAlignment) SampleType reverbLineInputs[numReverbLines][subBlockSize];
+};
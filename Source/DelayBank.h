@@ -0,0 +1,114 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "DelayLine.h"
+
+//==============================================================================
+// Delay Bank - every delay line of the engine in one allocation
+//
+// All line buffers sit back to back in a single cache-line aligned slab, and
+// all per-line hot state sits in one packed array with each channel's lines
+// filling exactly four cache lines. Each buffer start is nudged by one extra
+// cache line per line so power-of-two sized lines don't all map onto the same
+// cache sets.
+//==============================================================================
+template <typename SampleType>
+class DelayBank
+{
+public:
+    static constexpr int maxLinesPerChannel = 8;
+
+    // maxDelaySeconds holds one entry per line of a channel
+    void prepare(double sampleRate, int newNumChannels,
+                 const float* maxDelaySeconds, int newLinesPerChannel)
+    {
+        jassert(newLinesPerChannel <= maxLinesPerChannel);
+
+        numChannels = newNumChannels;
+        linesPerChannel = newLinesPerChannel;
+
+        auto numStates = (size_t)(numChannels * maxLinesPerChannel);
+        stateStorage.calloc(numStates * sizeof(LineState) + cacheLineSize);
+        states = juce::snapPointerToAlignment(reinterpret_cast<LineState*>(stateStorage.get()),
+                                              cacheLineSize);
+
+        offsets.calloc(numStates);
+
+        size_t totalSize = 0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int line = 0; line < linesPerChannel; ++line)
+            {
+                // +3 leaves room for the oldest four-tap interpolation tap at the maximum delay
+                auto requiredSize = (int)std::ceil(sampleRate * maxDelaySeconds[line]) + 3;
+                auto size = juce::nextPowerOfTwo(juce::jmax(requiredSize, 16));
+                auto index = getIndex(channel, line);
+
+                totalSize += samplesPerCacheLine;
+                offsets[index] = totalSize;
+                totalSize += (size_t)size;
+
+                states[index] = LineState();
+                states[index].mask = size - 1;
+            }
+        }
+
+        slabStorage.calloc(totalSize + samplesPerCacheLine);
+        slab = juce::snapPointerToAlignment(slabStorage.get(), cacheLineSize);
+        slabSize = totalSize;
+    }
+
+    void clear() noexcept
+    {
+        juce::FloatVectorOperations::clear(slab, (int)slabSize);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int line = 0; line < linesPerChannel; ++line)
+            {
+                auto& state = states[getIndex(channel, line)];
+                state.writePosition = 0;
+                state.delay = 0.0f;
+                state.fadeRemaining = 0;
+                state.allpassState = 0;
+            }
+        }
+    }
+
+    // Crossfade length for delay changes on every line
+    void setFadeLength(int numSamples) noexcept   { fadeLength = numSamples; }
+
+    DelayLine<SampleType> getLine(int channel, int line) noexcept
+    {
+        jassert(channel < numChannels && line < linesPerChannel);
+
+        auto index = getIndex(channel, line);
+        return { slab + offsets[index], states[index], fadeLength };
+    }
+
+    size_t getMemoryUsageBytes() const noexcept   { return slabSize * sizeof(SampleType); }
+
+private:
+    using LineState = DelayLineState<SampleType>;
+
+    static constexpr size_t cacheLineSize = 64;
+    static constexpr size_t samplesPerCacheLine = cacheLineSize / sizeof(SampleType);
+
+    // With a double allpass state each state is 40 bytes and a channel fills five
+    static_assert(sizeof(DelayLineState<float>) * maxLinesPerChannel == 4 * cacheLineSize,
+                  "A channel's float line state should fill exactly four cache lines");
+
+    static int getIndex(int channel, int line) noexcept   { return channel * maxLinesPerChannel + line; }
+
+    juce::HeapBlock<SampleType> slabStorage;
+    juce::HeapBlock<char> stateStorage;
+    juce::HeapBlock<size_t> offsets;
+
+    SampleType* slab = nullptr;
+    LineState* states = nullptr;
+    size_t slabSize = 0;
+    int numChannels = 0;
+    int linesPerChannel = 0;
+    int fadeLength = 0;
+};
@@ -0,0 +1,451 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Hot per-line state, packed so a channel's lines share a couple of cache lines.
+// Delays and gains stay float at either sample precision; only the allpass
+// state is a sample.
+//==============================================================================
+template <typename SampleType>
+struct DelayLineState
+{
+    int writePosition = 0;
+    int mask = 0;
+    float feedback = 0.0f;      // Current feedback gain
+    float delay = 0.0f;         // Delay of the current read head, 0 until the first block
+    float previousDelay = 0.0f; // Delay of the read head being faded out
+    float targetDelay = 1.0f;   // Most recently requested delay
+    int fadeRemaining = 0;      // Samples left in the running crossfade
+    SampleType allpassState = 0;    // Last output of the allpass interpolator
+};
+
+//==============================================================================
+// Fractional delay interpolators, from cheapest to most transparent. The
+// four-tap kernels and the allpass read one sample newer than the delay, so
+// they need a delay of at least two samples.
+//==============================================================================
+enum class DelayInterpolation
+{
+    linear,     // Two taps; rolls off the top octave at half-sample delays
+    hermite,    // Four-tap cubic Hermite (Catmull-Rom)
+    lagrange3,  // Four-tap third-order Lagrange
+    allpass     // First-order Thiran allpass, flat magnitude; fixed delays only
+};
+
+//==============================================================================
+// Delay Line - Power-of-two circular buffer with interpolation
+//
+// The capacity is rounded up to a power of two so every wraparound is a single
+// mask instead of a modulo or a loop. Block writes copy in at most two
+// contiguous spans, block reads work on raw pointers.
+//
+// A DelayLine is a lightweight view: the samples live in a DelayBank slab and
+// the write position/mask in the bank's packed state array. Copying it is
+// cheap and copies still refer to the same line.
+//
+// Delays are measured from the write position at the start of a block: sample i
+// of a block read is taken at (writePosition + i - delay[i]). Reading a block
+// before writing it is therefore only valid while every delay[i] >= i + 1, which
+// is what feedback paths rely on when they process a block in one go.
+//
+// Delay changes don't move the read head. The new delay gets a second head and
+// the old one is crossfaded out over fadeLength samples; a change that arrives
+// mid-fade waits for the running fade to finish. A line that isn't fading
+// reads exactly as before.
+//
+// The four-tap interpolators compute their weights once per block for fixed
+// delays, leaving a contiguous four-tap FIR, and for modulated delays gather
+// the taps of a group of samples first so the weights and the sum run across
+// vector lanes.
+//
+// Samples are float or double; per-sample delays come in the sample type too,
+// since they're built from the LFO's output.
+//==============================================================================
+template <typename SampleType>
+class DelayLine
+{
+public:
+    DelayLine() = default;
+
+    DelayLine(SampleType* storage, DelayLineState<SampleType>& lineState, int crossfadeLength) noexcept
+        : buffer(storage), state(&lineState), fadeLength(crossfadeLength)
+    {
+    }
+
+    static float getMinimumDelay(DelayInterpolation interpolation) noexcept
+    {
+        return interpolation == DelayInterpolation::linear ? 1.0f : 2.0f;
+    }
+
+    void clear() noexcept
+    {
+        clearSamples(0, getCapacity());
+        resetState();
+    }
+
+    // Silences part of the buffer without touching the read state, so a long
+    // line can be cleared a slice at a time
+    void clearSamples(int start, int numSamples) noexcept
+    {
+        jassert(start >= 0 && start + numSamples <= getCapacity());
+        juce::FloatVectorOperations::clear(buffer + start, numSamples);
+    }
+
+    // Puts the heads back where a silent line has them
+    void resetState() noexcept
+    {
+        state->writePosition = 0;
+
+        // Nothing to fade from in a silent line
+        state->delay = 0.0f;
+        state->fadeRemaining = 0;
+        state->allpassState = 0.0f;
+    }
+
+    int getCapacity() const noexcept       { return state->mask + 1; }
+
+    // Largest delay (in samples) that can be read back without wrapping, with
+    // room for the oldest tap of the four-tap interpolators
+    float getMaximumDelay() const noexcept { return (float)(state->mask - 2); }
+
+    float getDelay() const noexcept        { return state->delay; }
+    float getPreviousDelay() const noexcept { return state->previousDelay; }
+    float getFeedback() const noexcept     { return state->feedback; }
+
+    void setParameters(float delayInSamples, float feedback) noexcept
+    {
+        state->targetDelay = delayInSamples;
+        state->feedback = feedback;
+    }
+
+    //==========================================================================
+    // Called once at the start of every block, before reading: moves to the
+    // requested delay, starting a crossfade if it differs from the current one
+    void beginBlock() noexcept
+    {
+        auto& s = *state;
+
+        if (s.fadeRemaining > 0 || s.targetDelay == s.delay)
+            return;
+
+        if (s.delay > 0.0f && fadeLength > 0)
+        {
+            s.previousDelay = s.delay;
+            s.fadeRemaining = fadeLength;
+        }
+
+        s.delay = s.targetDelay;
+    }
+
+    bool isFading() const noexcept         { return state->fadeRemaining > 0; }
+    void finishFade() noexcept             { state->fadeRemaining = 0; }
+
+    // Blends the old head's samples into the new head's block along the fade
+    // ramp and advances the fade. Samples past the end of the fade are left as
+    // they are.
+    void applyFade(const SampleType* previousHeadSamples, SampleType* output, int numSamples) noexcept
+    {
+        auto remaining = state->fadeRemaining;
+        auto count = juce::jmin(numSamples, remaining);
+        auto step = (SampleType)1 / (SampleType)fadeLength;
+        auto start = (SampleType)(fadeLength - remaining) * step;
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto gain = start + (SampleType)i * step;
+            output[i] = previousHeadSamples[i] + gain * (output[i] - previousHeadSamples[i]);
+        }
+
+        state->fadeRemaining = remaining - count;
+    }
+
+    //==========================================================================
+    void writeSample(SampleType sample) noexcept
+    {
+        buffer[state->writePosition] = sample;
+        state->writePosition = (state->writePosition + 1) & state->mask;
+    }
+
+    // Read with linear interpolation
+    SampleType readSample(float delayInSamples) const noexcept
+    {
+        jassert(delayInSamples >= 0.0f && delayInSamples <= getMaximumDelay());
+
+        auto mask = state->mask;
+        auto delayInt = (int)delayInSamples;
+        auto frac = (SampleType)(delayInSamples - (float)delayInt);
+
+        auto index1 = (state->writePosition - delayInt) & mask;
+        auto index2 = (index1 - 1) & mask;
+
+        SampleType sample1 = buffer[index1];
+        SampleType sample2 = buffer[index2];
+
+        return sample1 + frac * (sample2 - sample1);
+    }
+
+    //==========================================================================
+    // Appends numSamples to the line, wrapping in at most two spans
+    void write(const SampleType* input, int numSamples) noexcept
+    {
+        jassert(numSamples <= getCapacity());
+
+        auto writePosition = state->writePosition;
+        auto firstSpan = juce::jmin(numSamples, getCapacity() - writePosition);
+        juce::FloatVectorOperations::copy(buffer + writePosition, input, firstSpan);
+
+        if (firstSpan < numSamples)
+            juce::FloatVectorOperations::copy(buffer, input + firstSpan, numSamples - firstSpan);
+
+        state->writePosition = (writePosition + numSamples) & state->mask;
+    }
+
+    // Reads numSamples at a fixed delay
+    void read(float delayInSamples, SampleType* output, int numSamples,
+              DelayInterpolation interpolation = DelayInterpolation::linear) noexcept
+    {
+        jassert(delayInSamples >= (float)numSamples + getMinimumDelay(interpolation) - 1.0f
+                 && delayInSamples <= getMaximumDelay());
+
+        switch (interpolation)
+        {
+            case DelayInterpolation::linear:    readLinear(delayInSamples, output, numSamples); break;
+            case DelayInterpolation::hermite:   readCubic<HermiteWeights>(delayInSamples, output, numSamples); break;
+            case DelayInterpolation::lagrange3: readCubic<LagrangeWeights>(delayInSamples, output, numSamples); break;
+            case DelayInterpolation::allpass:   readAllpass(delayInSamples, output, numSamples); break;
+        }
+    }
+
+    // Reads numSamples backwards, starting startOffset samples before the newest
+    // one: output[i] is the sample (startOffset + i + 1) before the write
+    // position. Everything read is older than the block, so unlike a forward
+    // read this never has to wait for the block's own writes.
+    void readReverse(int startOffset, SampleType* output, int numSamples) const noexcept
+    {
+        jassert(startOffset >= 0 && startOffset + numSamples <= getCapacity());
+
+        auto mask = state->mask;
+        auto position = (state->writePosition - 1 - startOffset) & mask;
+        auto done = 0;
+
+        while (done < numSamples)
+        {
+            auto span = juce::jmin(numSamples - done, position + 1);
+            const auto* source = buffer + position;
+            auto* out = output + done;
+
+            for (int i = 0; i < span; ++i)
+                out[i] = source[-i];
+
+            done += span;
+            position = (position - span) & mask;
+        }
+    }
+
+    // Reads numSamples with a separate delay per sample (modulated taps)
+    void readModulated(const SampleType* delays, SampleType* output, int numSamples,
+                       DelayInterpolation interpolation = DelayInterpolation::linear) const noexcept
+    {
+        switch (interpolation)
+        {
+            case DelayInterpolation::hermite:   readModulatedCubic<HermiteWeights>(delays, output, numSamples); break;
+            case DelayInterpolation::lagrange3: readModulatedCubic<LagrangeWeights>(delays, output, numSamples); break;
+            case DelayInterpolation::allpass:   jassertfalse; [[fallthrough]]; // The allpass can't follow a moving delay
+            case DelayInterpolation::linear:    readModulatedLinear(delays, output, numSamples); break;
+        }
+    }
+
+private:
+    //==========================================================================
+    // Weights for the taps one newer than, at, one older than and two older
+    // than the integer delay, interpolating a fraction t towards the older tap
+    struct HermiteWeights
+    {
+        template <typename T>
+        static void get(T t, T& newer, T& w0, T& w1, T& older) noexcept
+        {
+            const T half = (T)0.5, oneAndHalf = (T)1.5;
+            newer = ((-half * t + (T)1) * t - half) * t;
+            w0 = (oneAndHalf * t - (T)2.5) * t * t + (T)1;
+            w1 = ((-oneAndHalf * t + (T)2) * t + half) * t;
+            older = (half * t - half) * t * t;
+        }
+    };
+
+    struct LagrangeWeights
+    {
+        template <typename T>
+        static void get(T t, T& newer, T& w0, T& w1, T& older) noexcept
+        {
+            const T half = (T)0.5, sixth = (T)1 / (T)6;
+            auto tp1 = t + (T)1, tm1 = t - (T)1, tm2 = t - (T)2;
+            newer = -t * tm1 * tm2 * sixth;
+            w0 = tp1 * tm1 * tm2 * half;
+            w1 = -tp1 * t * tm2 * half;
+            older = tp1 * t * tm1 * sixth;
+        }
+    };
+
+    //==========================================================================
+    // The integer part of the delay is the same for the whole block, so both
+    // taps walk forward through at most two contiguous spans of the buffer.
+    void readLinear(float delayInSamples, SampleType* output, int numSamples) const noexcept
+    {
+        auto mask = state->mask;
+        auto delayInt = (int)delayInSamples;
+        auto frac = (SampleType)(delayInSamples - (float)delayInt);
+
+        // Start at the older tap; the newer tap is always one sample ahead
+        auto start = (state->writePosition - delayInt - 1) & mask;
+        auto done = 0;
+
+        while (done < numSamples)
+        {
+            // Stop one short of the end so index + 1 never wraps inside the span
+            auto span = juce::jmin(numSamples - done, mask - start);
+
+            if (span == 0)
+            {
+                // The newer tap sits at index 0 after the wrap
+                auto older = buffer[mask];
+                output[done++] = buffer[0] + frac * (older - buffer[0]);
+                start = 0;
+                continue;
+            }
+
+            auto* older = buffer + start;
+            auto* newer = older + 1;
+            auto* out = output + done;
+
+            for (int i = 0; i < span; ++i)
+                out[i] = newer[i] + frac * (older[i] - newer[i]);
+
+            done += span;
+            start = (start + span) & mask;
+        }
+    }
+
+    void readModulatedLinear(const SampleType* delays, SampleType* output, int numSamples) const noexcept
+    {
+        const auto* data = buffer;
+        auto mask = state->mask;
+        auto writePosition = state->writePosition;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            jassert(delays[i] >= (SampleType)(i + 1) && delays[i] <= (SampleType)getMaximumDelay());
+
+            auto delayInt = (int)delays[i];
+            auto frac = delays[i] - (SampleType)delayInt;
+
+            auto index1 = (writePosition + i - delayInt) & mask;
+            auto index2 = (index1 - 1) & mask;
+
+            output[i] = data[index1] + frac * (data[index2] - data[index1]);
+        }
+    }
+
+    // With a fixed delay the weights are constant, leaving a four-tap FIR over
+    // contiguous samples. Only the rare block whose taps straddle the end of
+    // the buffer falls back to masked indexing.
+    template <typename Weights>
+    void readCubic(float delayInSamples, SampleType* output, int numSamples) const noexcept
+    {
+        auto mask = state->mask;
+        auto delayInt = (int)delayInSamples;
+        SampleType newer, w0, w1, older;
+        Weights::get((SampleType)(delayInSamples - (float)delayInt), newer, w0, w1, older);
+
+        auto start = (state->writePosition - delayInt - 2) & mask;
+
+        if (start + numSamples + 3 <= mask + 1)
+        {
+            const auto* taps = buffer + start;
+
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = older * taps[i] + w1 * taps[i + 1] + w0 * taps[i + 2] + newer * taps[i + 3];
+
+            return;
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto index = start + i;
+            output[i] = older * buffer[index & mask] + w1 * buffer[(index + 1) & mask]
+                      + w0 * buffer[(index + 2) & mask] + newer * buffer[(index + 3) & mask];
+        }
+    }
+
+    // Taps are gathered for a group of samples, then the weights and the sum
+    // are evaluated for the whole group in plain loops the compiler vectorises
+    template <typename Weights>
+    void readModulatedCubic(const SampleType* delays, SampleType* output, int numSamples) const noexcept
+    {
+        constexpr int groupSize = 16;
+        SampleType tapNewer[groupSize], tap0[groupSize], tap1[groupSize], tapOlder[groupSize], fraction[groupSize];
+
+        auto mask = state->mask;
+        auto writePosition = state->writePosition;
+
+        for (int groupStart = 0; groupStart < numSamples; groupStart += groupSize)
+        {
+            auto count = juce::jmin(groupSize, numSamples - groupStart);
+
+            for (int j = 0; j < count; ++j)
+            {
+                auto i = groupStart + j;
+                jassert(delays[i] >= (SampleType)(i + 2) && delays[i] <= (SampleType)getMaximumDelay());
+
+                auto delayInt = (int)delays[i];
+                auto index = writePosition + i - delayInt;
+                fraction[j] = delays[i] - (SampleType)delayInt;
+                tapNewer[j] = buffer[(index + 1) & mask];
+                tap0[j] = buffer[index & mask];
+                tap1[j] = buffer[(index - 1) & mask];
+                tapOlder[j] = buffer[(index - 2) & mask];
+            }
+
+            for (int j = 0; j < count; ++j)
+            {
+                SampleType newer, w0, w1, older;
+                Weights::get(fraction[j], newer, w0, w1, older);
+                output[groupStart + j] = newer * tapNewer[j] + w0 * tap0[j] + w1 * tap1[j] + older * tapOlder[j];
+            }
+        }
+    }
+
+    // First-order Thiran allpass: y = a * x[n] + x[n + 1] - a * y', with the
+    // fraction kept in [0.5, 1.5) where the coefficient stays well inside the
+    // unit circle. Recursive, so it runs sample by sample.
+    void readAllpass(float delayInSamples, SampleType* output, int numSamples) noexcept
+    {
+        auto mask = state->mask;
+        auto delayInt = (int)delayInSamples;
+        auto frac = (SampleType)(delayInSamples - (float)delayInt);
+
+        if (frac < (SampleType)0.5)
+        {
+            --delayInt;
+            frac += (SampleType)1;
+        }
+
+        auto coefficient = ((SampleType)1 - frac) / ((SampleType)1 + frac);
+        auto previous = state->allpassState;
+        auto index = state->writePosition - delayInt;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto current = buffer[(index + i) & mask];
+            auto older = buffer[(index + i - 1) & mask];
+            previous = coefficient * (current - previous) + older;
+            output[i] = previous;
+        }
+
+        state->allpassState = previous;
+    }
+
+    SampleType* buffer = nullptr;
+    DelayLineState<SampleType>* state = nullptr;
+    int fadeLength = 0;
+};
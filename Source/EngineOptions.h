@@ -0,0 +1,168 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ClaritizerEngine.h"
+
+//==============================================================================
+// Engine Options - engine choices that aren't plugin parameters
+//
+// Which interpolator each module's delay lines read with, and which saturator
+// sits in its feedback loops. The plugin runs the defaults; the command-line
+// tools change them to compare the choices by ear and by benchmark, passing
+// text like "delay1=lagrange3/allpass" (modulated, then fixed), "reverb=adaa",
+// or just "linear" for every module and both cases.
+//
+// A build picks the defaults for every module by naming the enumerators, e.g.
+// CLARITIZER_MODULATED_INTERPOLATION=lagrange3 or CLARITIZER_SATURATION=antialiased
+// in the exporter's preprocessor definitions, trading CPU for quality per
+// deployment without touching the source.
+//==============================================================================
+#ifndef CLARITIZER_MODULATED_INTERPOLATION
+ #define CLARITIZER_MODULATED_INTERPOLATION hermite
+#endif
+
+#ifndef CLARITIZER_FIXED_INTERPOLATION
+ #define CLARITIZER_FIXED_INTERPOLATION allpass
+#endif
+
+#ifndef CLARITIZER_SATURATION
+ #define CLARITIZER_SATURATION softClip
+#endif
+
+struct EngineOptions
+{
+    static constexpr int numModules = ClaritizerEngine<float>::numModules;
+
+    static constexpr DelayInterpolation defaultModulatedInterpolation = DelayInterpolation::CLARITIZER_MODULATED_INTERPOLATION;
+    static constexpr DelayInterpolation defaultFixedInterpolation = DelayInterpolation::CLARITIZER_FIXED_INTERPOLATION;
+    static constexpr SaturationMode defaultSaturation = SaturationMode::CLARITIZER_SATURATION;
+
+    static_assert(defaultModulatedInterpolation != DelayInterpolation::allpass,
+                  "The allpass only works for fixed delays");
+
+    struct Interpolation
+    {
+        DelayInterpolation modulated = defaultModulatedInterpolation;
+        DelayInterpolation fixed = defaultFixedInterpolation;
+    };
+
+    std::array<Interpolation, numModules> interpolation;
+    std::array<SaturationMode, numModules> saturation = makeSaturationDefaults();
+
+    // Hands every option to an engine; cheap enough to call every block
+    template <typename SampleType>
+    void applyTo(ClaritizerEngine<SampleType>& engine) const noexcept
+    {
+        using Module = typename ClaritizerEngine<SampleType>::Module;
+
+        for (int module = 0; module < numModules; ++module)
+        {
+            const auto& choice = interpolation[(size_t)module];
+            engine.setInterpolation((Module)module, choice.modulated, choice.fixed);
+            engine.setSaturation((Module)module, saturation[(size_t)module]);
+        }
+    }
+
+    //==========================================================================
+    static constexpr const char* moduleNames[] = { "chorus", "delay1", "delay2", "reverb" };
+    static constexpr const char* interpolationNames[] = { "linear", "hermite", "lagrange3", "allpass" };
+    static constexpr const char* saturationNames[] = { "softclip", "adaa" };
+
+    static_assert(sizeof(moduleNames) / sizeof(moduleNames[0]) == (size_t)numModules, "A module has no name");
+
+    static const char* getInterpolationName(DelayInterpolation choice) noexcept
+    {
+        return interpolationNames[(size_t)choice];
+    }
+
+    static const char* getSaturationName(SaturationMode mode) noexcept
+    {
+        return saturationNames[(size_t)mode];
+    }
+
+    // Sets the interpolation from "[module=]modulated[/fixed]". Without a
+    // module every module changes; without a fixed choice both cases use the
+    // same one.
+    juce::Result parseInterpolation(const juce::String& text)
+    {
+        int module;
+        juce::String choices;
+
+        if (! splitModule(text, module, choices))
+            return juce::Result::fail("Unknown module in " + text);
+
+        auto modulated = find(interpolationNames, choices.upToFirstOccurrenceOf("/", false, false));
+        auto fixed = choices.containsChar('/') ? find(interpolationNames, choices.fromFirstOccurrenceOf("/", false, false))
+                                               : modulated;
+
+        if (modulated < 0 || fixed < 0)
+            return juce::Result::fail("Unknown interpolation in " + text);
+
+        if ((DelayInterpolation)modulated == DelayInterpolation::allpass)
+            return juce::Result::fail("The allpass only works for fixed delays: " + text);
+
+        for (int i = 0; i < numModules; ++i)
+            if (module < 0 || module == i)
+                interpolation[(size_t)i] = { (DelayInterpolation)modulated, (DelayInterpolation)fixed };
+
+        return juce::Result::ok();
+    }
+
+    // Sets the saturation from "[module=]softclip" or "[module=]adaa"
+    juce::Result parseSaturation(const juce::String& text)
+    {
+        int module;
+        juce::String name;
+
+        if (! splitModule(text, module, name))
+            return juce::Result::fail("Unknown module in " + text);
+
+        auto mode = find(saturationNames, name);
+
+        if (mode < 0)
+            return juce::Result::fail("Unknown saturation in " + text);
+
+        for (int i = 0; i < numModules; ++i)
+            if (module < 0 || module == i)
+                saturation[(size_t)i] = (SaturationMode)mode;
+
+        return juce::Result::ok();
+    }
+
+private:
+    static constexpr std::array<SaturationMode, numModules> makeSaturationDefaults() noexcept
+    {
+        std::array<SaturationMode, numModules> modes {};
+
+        for (auto& mode : modes)
+            mode = defaultSaturation;
+
+        return modes;
+    }
+
+    // Splits "[module=]value", module being -1 when there's none. Returns
+    // false for a module name that doesn't exist.
+    static bool splitModule(const juce::String& text, int& module, juce::String& value)
+    {
+        module = -1;
+        value = text;
+
+        if (! text.containsChar('='))
+            return true;
+
+        module = find(moduleNames, text.upToFirstOccurrenceOf("=", false, false));
+        value = text.fromFirstOccurrenceOf("=", false, false);
+        return module >= 0;
+    }
+
+    // Index of name in names, ignoring case, or -1
+    template <size_t numNames>
+    static int find(const char* const (&names)[numNames], const juce::String& name)
+    {
+        for (size_t i = 0; i < numNames; ++i)
+            if (name.trim().equalsIgnoreCase(names[i]))
+                return (int)i;
+
+        return -1;
+    }
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+//==============================================================================
+// Mode configuration - one complete set of module settings per mode (A-D)
+//==============================================================================
+
+// Chorus module configuration (series, pre-delays)
+struct ChorusConfig
+{
+    float timeMs;           // Chorus delay time (10-50ms typical)
+    float feedback;         // Light feedback (0.0-0.3)
+    float modDepth;         // LFO modulation depth in ms
+    float modRate;          // LFO rate in Hz
+    float mix;              // Chorus wet amount
+    float stereoPhase = 0.0f;   // LFO phase offset of the right channel in degrees
+};
+
+// Main delay configuration (parallel)
+struct DelayConfig
+{
+    float baseTimeMs;       // Base delay time (before TIME knob scaling)
+    float feedback;         // Feedback amount (0.0 - 0.95)
+    float modDepth;         // LFO modulation depth in ms
+    float modRate;          // LFO rate in Hz
+    float mix;              // Output mix (0.0 = muted, 1.0 = full)
+    bool reverse;           // Play back each delay-length segment reversed
+    float stereoPhase = 0.0f;   // LFO phase offset of the right channel in degrees
+};
+
+// Reverb module configuration (feedback delay network, post-delays)
+struct ReverbConfig
+{
+    float delay1Time;       // First line length in ms
+    float delay2Time;       // Second line length in ms
+    float delay3Time;       // Third line length in ms
+    float delay4Time;       // Fourth line length in ms
+    float sharedFeedback;   // Feedback of a line of average length
+    float mix;              // Reverb wet/dry mix
+    float damping = 0.3f;   // High-frequency loss per trip round an average line (0.0 - 0.95)
+    float modDepth = 0.3f;  // Line length modulation depth in ms
+    float modRate = 0.7f;   // Line length modulation rate in Hz
+};
+
+// Complete mode configuration
+struct ModeConfig
+{
+    ChorusConfig chorus;
+    DelayConfig delay1;
+    DelayConfig delay2;
+    ReverbConfig reverb;
+};
+
+// Largest values the debug sliders and the TIME knob can ask for. Delay memory
+// is sized from these, so anything that widens a range must go through here.
+struct ModeConfigLimits
+{
+    static constexpr float maxChorusTimeMs = 50.0f;
+    static constexpr float maxDelayTimeMs = 2000.0f;
+    static constexpr float maxReverbTimeMs = 500.0f;
+    static constexpr float maxModDepthMs = 50.0f;
+    static constexpr float minTimeScale = 0.1f;     // TIME knob range is 0.1 - 3.0
+    static constexpr float maxTimeScale = 3.0f;
+};
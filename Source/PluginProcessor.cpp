@@ -1,474 +1,645 @@
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-ClaritizerAudioProcessor::ClaritizerAudioProcessor()
-    : AudioProcessor(BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput("Input", juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                     ),
-      parameters(*this, nullptr, juce::Identifier("PARAMETERS"), createParameterLayout())
-{
-    clarityParam = parameters.getRawParameterValue("clarity");
-    timeParam = parameters.getRawParameterValue("time");
-    toneParam = parameters.getRawParameterValue("tone");
-    modeParam = parameters.getRawParameterValue("mode");
-}
-
-ClaritizerAudioProcessor::~ClaritizerAudioProcessor()
-{
-}
-
-juce::AudioProcessorValueTreeState::ParameterLayout ClaritizerAudioProcessor::createParameterLayout()
-{
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("clarity", 1),
-        "Clarity",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.5f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("time", 1),
-        "Time",
-        juce::NormalisableRange<float>(0.1f, 3.0f, 0.01f),
-        1.0f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("tone", 1),
-        "Tone",
-        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-        0.5f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("mode", 1),
-        "Mode",
-        juce::NormalisableRange<float>(0.0f, 3.0f, 1.0f),
-        0.0f));
-    
-    return layout;
-}
-
-//==============================================================================
-// MODE CONFIGURATIONS - All modes start identical
-//==============================================================================
-ClaritizerAudioProcessor::ModeConfig ClaritizerAudioProcessor::getModeConfig(int mode)
-{
-    if (useDebugConfigs)
-    {
-        return debugModeConfigs[mode];
-    }
-    
-    // All modes start with same defaults (like original Mode A)
-    ModeConfig config;
-    
-    // Chorus (bypassed initially - user can enable via debug sliders)
-    config.chorus.timeMs = 30.0f;      // Good starting point for chorus
-    config.chorus.feedback = 0.0f;      // No feedback initially
-    config.chorus.modDepth = 0.0f;      // No modulation initially
-    config.chorus.modRate = 0.0f;       // No LFO initially
-    config.chorus.mix = 0.0f;           // BYPASSED - enable via sliders
-    
-    // Delay 1 (main delay - 250ms like original Mode A)
-    config.delay1.baseTimeMs = 250.0f;
-    config.delay1.feedback = 0.4f;
-    config.delay1.modDepth = 0.0f;
-    config.delay1.modRate = 0.0f;
-    config.delay1.mix = 1.0f;           // Active
-    config.delay1.reverse = false;
-    
-    // Delay 2 (muted initially)
-    config.delay2.baseTimeMs = 100.0f;
-    config.delay2.feedback = 0.0f;
-    config.delay2.modDepth = 0.0f;
-    config.delay2.modRate = 0.0f;
-    config.delay2.mix = 0.0f;           // MUTED - enable via sliders
-    config.delay2.reverse = false;
-    
-    // Reverb (good starting delays for diffusion network, bypassed initially)
-    config.reverb.delay1Time = 37.0f;   // Prime numbers for good diffusion
-    config.reverb.delay2Time = 83.0f;
-    config.reverb.delay3Time = 127.0f;
-    config.reverb.delay4Time = 211.0f;
-    config.reverb.sharedFeedback = 0.0f; // No feedback initially
-    config.reverb.mix = 0.0f;            // BYPASSED - enable via sliders
-    
-    return config;
-}
-
-//==============================================================================
-// Safety limiter
-//==============================================================================
-float ClaritizerAudioProcessor::softClip(float sample)
-{
-    if (std::abs(sample) > 0.9f)
-        return std::tanh(sample * 0.5f) * 1.2f;
-    return sample;
-}
-
-//==============================================================================
-const juce::String ClaritizerAudioProcessor::getName() const
-{
-    return JucePlugin_Name;
-}
-
-bool ClaritizerAudioProcessor::acceptsMidi() const
-{
-   #if JucePlugin_WantsMidiInput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool ClaritizerAudioProcessor::producesMidi() const
-{
-   #if JucePlugin_ProducesMidiOutput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool ClaritizerAudioProcessor::isMidiEffect() const
-{
-   #if JucePlugin_IsMidiEffect
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-double ClaritizerAudioProcessor::getTailLengthSeconds() const
-{
-    return 0.0;
-}
-
-int ClaritizerAudioProcessor::getNumPrograms()
-{
-    return 1;
-}
-
-int ClaritizerAudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
-
-void ClaritizerAudioProcessor::setCurrentProgram(int index)
-{
-}
-
-const juce::String ClaritizerAudioProcessor::getProgramName(int index)
-{
-    return {};
-}
-
-void ClaritizerAudioProcessor::changeProgramName(int index, const juce::String& newName)
-{
-}
-
-//==============================================================================
-void ClaritizerAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
-{
-    // Setup DSP spec
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 2;
-    
-    // Setup all delay lines (5 seconds max - plenty of room)
-    chorusLeft.prepare(sampleRate, 5.0f);
-    chorusRight.prepare(sampleRate, 5.0f);
-    delay1Left.prepare(sampleRate, 5.0f);
-    delay1Right.prepare(sampleRate, 5.0f);
-    delay2Left.prepare(sampleRate, 5.0f);
-    delay2Right.prepare(sampleRate, 5.0f);
-    reverb1Left.prepare(sampleRate, 5.0f);
-    reverb1Right.prepare(sampleRate, 5.0f);
-    reverb2Left.prepare(sampleRate, 5.0f);
-    reverb2Right.prepare(sampleRate, 5.0f);
-    reverb3Left.prepare(sampleRate, 5.0f);
-    reverb3Right.prepare(sampleRate, 5.0f);
-    reverb4Left.prepare(sampleRate, 5.0f);
-    reverb4Right.prepare(sampleRate, 5.0f);
-    
-    // Setup all LFOs
-    chorusLFOLeft.prepare(sampleRate);
-    chorusLFORight.prepare(sampleRate);
-    lfo1Left.prepare(sampleRate);
-    lfo1Right.prepare(sampleRate);
-    lfo2Left.prepare(sampleRate);
-    lfo2Right.prepare(sampleRate);
-    
-    // Setup tone filter
-    toneFilter.prepare(spec);
-}
-
-void ClaritizerAudioProcessor::releaseResources()
-{
-}
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool ClaritizerAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
-{
-  #if JucePlugin_IsMidiEffect
-    juce::ignoreUnused(layouts);
-    return true;
-  #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-
-   #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-   #endif
-
-    return true;
-  #endif
-}
-#endif
-
-//==============================================================================
-void ClaritizerAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear(i, 0, buffer.getNumSamples());
-
-    // Get parameter values
-    float dryWet = clarityParam->load();
-    float timeScale = timeParam->load();
-    float toneValue = toneParam->load();
-    int mode = (int)(modeParam->load());
-    
-    // Get mode configuration
-    ModeConfig config = getModeConfig(mode);
-    
-    // Set LFO frequencies
-    chorusLFOLeft.setFrequency(config.chorus.modRate);
-    chorusLFORight.setFrequency(config.chorus.modRate);
-    lfo1Left.setFrequency(config.delay1.modRate);
-    lfo1Right.setFrequency(config.delay1.modRate);
-    lfo2Left.setFrequency(config.delay2.modRate);
-    lfo2Right.setFrequency(config.delay2.modRate);
-    
-    // Create wet buffer for processing
-    juce::AudioBuffer<float> wetBuffer;
-    wetBuffer.makeCopyOf(buffer);
-    
-    // Process each sample
-    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-    {
-        // LEFT CHANNEL
-        float input = wetBuffer.getSample(0, sample);
-        
-        // === CHORUS MODULE (series, pre) ===
-        float chorusTime = (config.chorus.timeMs * timeScale / 1000.0f) * (float)getSampleRate();
-        float chorusModDepth = (config.chorus.modDepth / 1000.0f) * (float)getSampleRate();
-        float chorusLFO = chorusLFOLeft.getNextSample();
-        float chorusDelay = juce::jmax(1.0f, chorusTime + (chorusLFO * chorusModDepth));
-        
-        float chorusDelayed = chorusLeft.readSample(chorusDelay);
-        float chorusFeedback = juce::jlimit(0.0f, 0.90f, config.chorus.feedback);
-        float chorusMixed = input + (chorusDelayed * chorusFeedback);
-        chorusMixed = softClip(chorusMixed);
-        chorusLeft.writeSample(chorusMixed);
-        
-        float chorusOutput = input * (1.0f - config.chorus.mix) + chorusMixed * config.chorus.mix;
-        
-        // === PARALLEL DELAYS (Delay 1 & 2) ===
-        
-        // Delay 1
-        float delay1Time = (config.delay1.baseTimeMs * timeScale / 1000.0f) * (float)getSampleRate();
-        float delay1ModDepth = (config.delay1.modDepth / 1000.0f) * (float)getSampleRate();
-        float lfo1 = lfo1Left.getNextSample();
-        float delay1 = juce::jmax(1.0f, delay1Time + (lfo1 * delay1ModDepth));
-        
-        float delayed1 = delay1Left.readSample(delay1);
-        float feedback1 = juce::jlimit(0.0f, 0.90f, config.delay1.feedback);
-        float mixed1 = chorusOutput + (delayed1 * feedback1);
-        mixed1 = softClip(mixed1);
-        delay1Left.writeSample(mixed1);
-        float output1 = mixed1 * config.delay1.mix;
-        
-        // Delay 2
-        float delay2Time = (config.delay2.baseTimeMs * timeScale / 1000.0f) * (float)getSampleRate();
-        float delay2ModDepth = (config.delay2.modDepth / 1000.0f) * (float)getSampleRate();
-        float lfo2 = lfo2Left.getNextSample();
-        float delay2 = juce::jmax(1.0f, delay2Time + (lfo2 * delay2ModDepth));
-        
-        float delayed2 = delay2Left.readSample(delay2);
-        float feedback2 = juce::jlimit(0.0f, 0.90f, config.delay2.feedback);
-        float mixed2 = chorusOutput + (delayed2 * feedback2);
-        mixed2 = softClip(mixed2);
-        delay2Left.writeSample(mixed2);
-        float output2 = mixed2 * config.delay2.mix;
-        
-        // Sum parallel delays
-        float parallelSum = output1 + output2;
-        
-        // === REVERB MODULE (series diffusion network, post) ===
-        float reverbFeedback = juce::jlimit(0.0f, 0.90f, config.reverb.sharedFeedback);
-        
-        // Delay 1
-        float rev1Time = (config.reverb.delay1Time * timeScale / 1000.0f) * (float)getSampleRate();
-        rev1Time = juce::jmax(1.0f, rev1Time);
-        float rev1Delayed = reverb1Left.readSample(rev1Time);
-        float rev1Mixed = parallelSum + (rev1Delayed * reverbFeedback);
-        rev1Mixed = softClip(rev1Mixed);
-        reverb1Left.writeSample(rev1Mixed);
-        
-        // Delay 2 (input is output of Delay 1)
-        float rev2Time = (config.reverb.delay2Time * timeScale / 1000.0f) * (float)getSampleRate();
-        rev2Time = juce::jmax(1.0f, rev2Time);
-        float rev2Delayed = reverb2Left.readSample(rev2Time);
-        float rev2Mixed = rev1Mixed + (rev2Delayed * reverbFeedback);
-        rev2Mixed = softClip(rev2Mixed);
-        reverb2Left.writeSample(rev2Mixed);
-        
-        // Delay 3 (input is output of Delay 2)
-        float rev3Time = (config.reverb.delay3Time * timeScale / 1000.0f) * (float)getSampleRate();
-        rev3Time = juce::jmax(1.0f, rev3Time);
-        float rev3Delayed = reverb3Left.readSample(rev3Time);
-        float rev3Mixed = rev2Mixed + (rev3Delayed * reverbFeedback);
-        rev3Mixed = softClip(rev3Mixed);
-        reverb3Left.writeSample(rev3Mixed);
-        
-        // Delay 4 (input is output of Delay 3)
-        float rev4Time = (config.reverb.delay4Time * timeScale / 1000.0f) * (float)getSampleRate();
-        rev4Time = juce::jmax(1.0f, rev4Time);
-        float rev4Delayed = reverb4Left.readSample(rev4Time);
-        float rev4Mixed = rev3Mixed + (rev4Delayed * reverbFeedback);
-        rev4Mixed = softClip(rev4Mixed);
-        reverb4Left.writeSample(rev4Mixed);
-        
-        // Mix reverb with dry parallel sum
-        float reverbOutput = parallelSum * (1.0f - config.reverb.mix) + rev4Mixed * config.reverb.mix;
-        
-        wetBuffer.setSample(0, sample, reverbOutput);
-        
-        // RIGHT CHANNEL (same logic)
-        input = wetBuffer.getSample(1, sample);
-        
-        // Chorus
-        chorusLFO = chorusLFORight.getNextSample();
-        chorusDelay = juce::jmax(1.0f, chorusTime + (chorusLFO * chorusModDepth));
-        chorusDelayed = chorusRight.readSample(chorusDelay);
-        chorusMixed = input + (chorusDelayed * chorusFeedback);
-        chorusMixed = softClip(chorusMixed);
-        chorusRight.writeSample(chorusMixed);
-        chorusOutput = input * (1.0f - config.chorus.mix) + chorusMixed * config.chorus.mix;
-        
-        // Delay 1
-        lfo1 = lfo1Right.getNextSample();
-        delay1 = juce::jmax(1.0f, delay1Time + (lfo1 * delay1ModDepth));
-        delayed1 = delay1Right.readSample(delay1);
-        mixed1 = chorusOutput + (delayed1 * feedback1);
-        mixed1 = softClip(mixed1);
-        delay1Right.writeSample(mixed1);
-        output1 = mixed1 * config.delay1.mix;
-        
-        // Delay 2
-        lfo2 = lfo2Right.getNextSample();
-        delay2 = juce::jmax(1.0f, delay2Time + (lfo2 * delay2ModDepth));
-        delayed2 = delay2Right.readSample(delay2);
-        mixed2 = chorusOutput + (delayed2 * feedback2);
-        mixed2 = softClip(mixed2);
-        delay2Right.writeSample(mixed2);
-        output2 = mixed2 * config.delay2.mix;
-        
-        parallelSum = output1 + output2;
-        
-        // Reverb series
-        rev1Delayed = reverb1Right.readSample(rev1Time);
-        rev1Mixed = parallelSum + (rev1Delayed * reverbFeedback);
-        rev1Mixed = softClip(rev1Mixed);
-        reverb1Right.writeSample(rev1Mixed);
-        
-        rev2Delayed = reverb2Right.readSample(rev2Time);
-        rev2Mixed = rev1Mixed + (rev2Delayed * reverbFeedback);
-        rev2Mixed = softClip(rev2Mixed);
-        reverb2Right.writeSample(rev2Mixed);
-        
-        rev3Delayed = reverb3Right.readSample(rev3Time);
-        rev3Mixed = rev2Mixed + (rev3Delayed * reverbFeedback);
-        rev3Mixed = softClip(rev3Mixed);
-        reverb3Right.writeSample(rev3Mixed);
-        
-        rev4Delayed = reverb4Right.readSample(rev4Time);
-        rev4Mixed = rev3Mixed + (rev4Delayed * reverbFeedback);
-        rev4Mixed = softClip(rev4Mixed);
-        reverb4Right.writeSample(rev4Mixed);
-        
-        reverbOutput = parallelSum * (1.0f - config.reverb.mix) + rev4Mixed * config.reverb.mix;
-        
-        wetBuffer.setSample(1, sample, reverbOutput);
-    }
-    
-    // Apply tone filter
-    float cutoffFreq = 200.0f + (toneValue * 18000.0f);
-    *toneFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(
-        getSampleRate(), cutoffFreq, 0.7f);
-    
-    juce::dsp::AudioBlock<float> wetBlock(wetBuffer);
-    juce::dsp::ProcessContextReplacing<float> wetContext(wetBlock);
-    toneFilter.process(wetContext);
-    
-    // Mix dry and wet with FINAL SAFETY LIMITING
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        auto* dryData = buffer.getWritePointer(channel);
-        auto* wetData = wetBuffer.getReadPointer(channel);
-        
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-        {
-            float drySample = dryData[sample];
-            float wetSample = wetData[sample];
-            
-            float output = drySample * (1.0f - dryWet) + wetSample * dryWet;
-            
-            // FINAL HARD LIMIT
-            output = juce::jlimit(-1.0f, 1.0f, output);
-            
-            dryData[sample] = output;
-        }
-    }
-}
-
-bool ClaritizerAudioProcessor::hasEditor() const
-{
-    return true;
-}
-
-juce::AudioProcessorEditor* ClaritizerAudioProcessor::createEditor()
-{
-    return new ClaritizerAudioProcessorEditor(*this);
-}
-
-void ClaritizerAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
-{
-    auto state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
-}
-
-void ClaritizerAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
-{
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-
-    if (xmlState.get() != nullptr)
-        if (xmlState->hasTagName(parameters.state.getType()))
-            parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
-}
-
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-    return new ClaritizerAudioProcessor();
-}
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+// Anything below -100 dBFS counts as silence for the sleep detector
+static constexpr float silenceThreshold = 1.0e-5f;
+static constexpr double sleepMarginSeconds = 0.05;   // Covers the tone filter's ring
+static constexpr int silenceCounterLimit = 1 << 30;
+
+// How long the TIME scale takes to follow the knob or a tempo change
+static constexpr double timeScaleGlideSeconds = 0.2;
+
+// Parameters that decide which oversampler the chain is prepared with
+static const char* const oversamplingParameterIDs[] = { "oversampling", "oversamplingFilter", "oversampleOfflineOnly" };
+
+template <typename SampleType>
+static bool isSilent(const juce::AudioBuffer<SampleType>& buffer, int numChannels)
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(channel),
+                                                                buffer.getNumSamples());
+        
+        if (range.getStart() < -silenceThreshold || range.getEnd() > silenceThreshold)
+            return false;
+    }
+    
+    return true;
+}
+
+//==============================================================================
+ClaritizerAudioProcessor::ClaritizerAudioProcessor()
+    : AudioProcessor(BusesProperties()
+                     #if ! JucePlugin_IsMidiEffect
+                      #if ! JucePlugin_IsSynth
+                       .withInput("Input", juce::AudioChannelSet::stereo(), true)
+                      #endif
+                       .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+                     #endif
+                     ),
+      parameters(*this, nullptr, juce::Identifier("PARAMETERS"), createParameterLayout())
+{
+    clarityParam = parameters.getRawParameterValue("clarity");
+    timeParam = parameters.getRawParameterValue("time");
+    toneParam = parameters.getRawParameterValue("tone");
+    modeParam = parameters.getRawParameterValue("mode");
+    oversamplingParam = parameters.getRawParameterValue("oversampling");
+    oversamplingFilterParam = parameters.getRawParameterValue("oversamplingFilter");
+    oversampleOfflineOnlyParam = parameters.getRawParameterValue("oversampleOfflineOnly");
+    syncParam = parameters.getRawParameterValue("sync");
+    syncDivisionParam = parameters.getRawParameterValue("syncDivision");
+    
+    for (auto& debugConfig : debugModeConfigs)
+        debugConfig.reset(getDefaultModeConfig());
+    
+    for (auto* id : oversamplingParameterIDs)
+        parameters.addParameterListener(id, this);
+    
+    floatChain.engine.setProfiler(&profiler);
+    doubleChain.engine.setProfiler(&profiler);
+}
+
+ClaritizerAudioProcessor::~ClaritizerAudioProcessor()
+{
+    for (auto* id : oversamplingParameterIDs)
+        parameters.removeParameterListener(id, this);
+    
+    cancelPendingUpdate();
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout ClaritizerAudioProcessor::createParameterLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("clarity", 1),
+        "Clarity",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.5f));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("time", 1),
+        "Time",
+        juce::NormalisableRange<float>(ModeConfigLimits::minTimeScale, ModeConfigLimits::maxTimeScale, 0.01f),
+        1.0f));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("tone", 1),
+        "Tone",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
+        0.5f));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("mode", 1),
+        "Mode",
+        juce::NormalisableRange<float>(0.0f, 3.0f, 1.0f),
+        0.0f));
+    
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("oversampling", 1),
+        "Oversampling",
+        juce::StringArray { "Off", "2x", "4x" },
+        0));
+    
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("oversamplingFilter", 1),
+        "Oversampling Filter",
+        juce::StringArray { "Polyphase IIR", "Linear Phase FIR" },
+        0));
+    
+    // Oversample bounces only, keeping live playback cheap
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("oversampleOfflineOnly", 1),
+        "Oversample Offline Only",
+        true));
+    
+    // Tempo sync replaces the TIME knob with a note division of the host tempo
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("sync", 1),
+        "Sync",
+        false));
+    
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("syncDivision", 1),
+        "Sync Division",
+        TempoSync::getDivisionNames(),
+        TempoSync::defaultDivision));
+    
+    return layout;
+}
+
+//==============================================================================
+// MODE CONFIGURATIONS - All modes start identical
+//==============================================================================
+ModeConfig ClaritizerAudioProcessor::getModeConfig(int mode)
+{
+    mode = juce::jlimit(0, 3, mode);
+    
+    if (useDebugConfigs.load())
+        return debugModeConfigs[(size_t)mode].read();
+    
+    return getDefaultModeConfig();
+}
+
+void ClaritizerAudioProcessor::setDebugModeConfig(int mode, const ModeConfig& config)
+{
+    debugModeConfigs[(size_t)juce::jlimit(0, 3, mode)].write(config);
+    useDebugConfigs.store(true);
+}
+
+void ClaritizerAudioProcessor::setEngineOptions(const EngineOptions& options)
+{
+    engineOptions.write(options);
+}
+
+//==============================================================================
+// TIME scale to head for: the knob, or in sync mode the scale that puts the
+// mode's chorus and reverb in proportion to the chosen note division of the
+// last known host tempo
+//==============================================================================
+float ClaritizerAudioProcessor::getTargetTimeScale(const ModeConfig& config) const
+{
+    if (! isSynced())
+        return timeParam->load();
+    
+    return TempoSync::getTimeScale(hostBpm, getSyncDivision(), TempoSync::getReferenceTimeMs(config));
+}
+
+bool ClaritizerAudioProcessor::isSynced() const
+{
+    return syncParam->load() >= 0.5f;
+}
+
+int ClaritizerAudioProcessor::getSyncDivision() const
+{
+    return juce::roundToInt(syncDivisionParam->load());
+}
+
+// In sync mode the delays sit on the division itself and only the chorus and
+// reverb follow the scale. Returns the TIME scale to run the config at.
+float ClaritizerAudioProcessor::applyTempoSync(ModeConfig& config, float scale) const
+{
+    if (! isSynced())
+        return scale;
+    
+    config = TempoSync::retime(config, hostBpm, getSyncDivision(), scale);
+    return 1.0f;
+}
+
+ModeConfig ClaritizerAudioProcessor::getDefaultModeConfig()
+{
+    // All modes start with same defaults (like original Mode A)
+    ModeConfig config;
+    
+    // Chorus (bypassed initially - user can enable via debug sliders)
+    config.chorus.timeMs = 30.0f;      // Good starting point for chorus
+    config.chorus.feedback = 0.0f;      // No feedback initially
+    config.chorus.modDepth = 0.0f;      // No modulation initially
+    config.chorus.modRate = 0.0f;       // No LFO initially
+    config.chorus.mix = 0.0f;           // BYPASSED - enable via sliders
+    config.chorus.stereoPhase = 0.0f;
+    
+    // Delay 1 (main delay - 250ms like original Mode A)
+    config.delay1.baseTimeMs = 250.0f;
+    config.delay1.feedback = 0.4f;
+    config.delay1.modDepth = 0.0f;
+    config.delay1.modRate = 0.0f;
+    config.delay1.mix = 1.0f;           // Active
+    config.delay1.reverse = false;
+    config.delay1.stereoPhase = 0.0f;
+    
+    // Delay 2 (muted initially)
+    config.delay2.baseTimeMs = 100.0f;
+    config.delay2.feedback = 0.0f;
+    config.delay2.modDepth = 0.0f;
+    config.delay2.modRate = 0.0f;
+    config.delay2.mix = 0.0f;           // MUTED - enable via sliders
+    config.delay2.reverse = false;
+    config.delay2.stereoPhase = 0.0f;
+    
+    // Reverb (good starting line lengths for the delay network, bypassed initially)
+    config.reverb.delay1Time = 37.0f;   // Prime numbers for good diffusion
+    config.reverb.delay2Time = 83.0f;
+    config.reverb.delay3Time = 127.0f;
+    config.reverb.delay4Time = 211.0f;
+    config.reverb.sharedFeedback = 0.0f; // No feedback initially
+    config.reverb.mix = 0.0f;            // BYPASSED - enable via sliders
+    config.reverb.damping = 0.3f;
+    config.reverb.modDepth = 0.3f;
+    config.reverb.modRate = 0.7f;
+    
+    return config;
+}
+
+//==============================================================================
+const juce::String ClaritizerAudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool ClaritizerAudioProcessor::acceptsMidi() const
+{
+   #if JucePlugin_WantsMidiInput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool ClaritizerAudioProcessor::producesMidi() const
+{
+   #if JucePlugin_ProducesMidiOutput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool ClaritizerAudioProcessor::isMidiEffect() const
+{
+   #if JucePlugin_IsMidiEffect
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+double ClaritizerAudioProcessor::getTailLengthSeconds() const
+{
+    return tailLengthSeconds.load();
+}
+
+int ClaritizerAudioProcessor::getNumPrograms()
+{
+    return 1;
+}
+
+int ClaritizerAudioProcessor::getCurrentProgram()
+{
+    return 0;
+}
+
+void ClaritizerAudioProcessor::setCurrentProgram(int index)
+{
+}
+
+const juce::String ClaritizerAudioProcessor::getProgramName(int index)
+{
+    return {};
+}
+
+void ClaritizerAudioProcessor::changeProgramName(int index, const juce::String& newName)
+{
+}
+
+//==============================================================================
+void ClaritizerAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    auto numChannels = juce::jlimit(1, ClaritizerEngine<float>::maxChannels,
+                                    juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()));
+    
+    preparedOversampling = getOversamplingChoice(sampleRate);
+    
+    // Only the chain for the host's precision gets any memory
+    auto latency = isUsingDoublePrecision() ? prepareChain(doubleChain, sampleRate, samplesPerBlock, numChannels)
+                                            : prepareChain(floatChain, sampleRate, samplesPerBlock, numChannels);
+    setLatencySamples(latency);
+    
+    clarityRamp.calloc((size_t)juce::jmax(samplesPerBlock, 1));
+    
+    clarity.reset(sampleRate, 0.05);
+    clarity.setCurrentAndTargetValue(clarityParam->load());
+    
+    auto config = getModeConfig((int)modeParam->load());
+    
+    timeScale.reset(sampleRate, timeScaleGlideSeconds);
+    timeScale.setCurrentAndTargetValue(getTargetTimeScale(config));
+    
+    auto engineTimeScale = applyTempoSync(config, timeScale.getCurrentValue());
+    tailLengthSeconds = ClaritizerEngine<float>::getTailLengthSeconds(config, engineTimeScale);
+    silentInputSamples = 0;
+    
+    profiler.prepare(sampleRate);
+    
+    preparedSampleRate = sampleRate;
+    preparedBlockSize = juce::jmax(samplesPerBlock, 1);
+}
+
+template <typename SampleType>
+int ClaritizerAudioProcessor::prepareChain(ProcessingChain<SampleType>& chain, double sampleRate,
+                                           int samplesPerBlock, int numChannels)
+{
+    auto stages = preparedOversampling.stages;
+    
+    // Setup delay lines and LFOs at the rate the engine runs at
+    chain.engine.prepare(sampleRate * (1 << stages), numChannels);
+    
+    // All scratch storage is sized here so processBlock never allocates
+    chain.wetBuffer.setSize(numChannels, juce::jmax(samplesPerBlock, 1));
+    
+    using Oversampling = juce::dsp::Oversampling<SampleType>;
+    auto latency = 0;
+    
+    chain.oversampler.reset();
+    
+    if (stages > 0)
+    {
+        auto filterType = preparedOversampling.filter == 0 ? Oversampling::filterHalfBandPolyphaseIIR
+                                                           : Oversampling::filterHalfBandFIREquiripple;
+        chain.oversampler = std::make_unique<Oversampling>((size_t)numChannels, (size_t)stages, filterType, true, true);
+        chain.oversampler->initProcessing((size_t)chain.wetBuffer.getNumSamples());
+        latency = juce::roundToInt(chain.oversampler->getLatencyInSamples());
+    }
+    
+    chain.dryDelay.setMaximumDelayInSamples(latency + 1);
+    chain.dryDelay.prepare({ sampleRate, (juce::uint32)chain.wetBuffer.getNumSamples(), (juce::uint32)numChannels });
+    chain.dryDelay.setDelay((SampleType)latency);
+    
+    // Setup tone filter, starting at the current knob position
+    chain.toneFilter.prepare(sampleRate, numChannels, toneParam->load());
+    
+    return latency;
+}
+
+void ClaritizerAudioProcessor::releaseResources()
+{
+    preparedBlockSize = 0;
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool ClaritizerAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused(layouts);
+    return true;
+  #else
+    // Anything from mono up to 7.1.4; every channel gets its own wet chain
+    auto numOutputChannels = layouts.getMainOutputChannelSet().size();
+    
+    if (numOutputChannels == 0 || numOutputChannels > ClaritizerEngine<float>::maxChannels)
+        return false;
+
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+
+    return true;
+  #endif
+}
+#endif
+
+//==============================================================================
+bool ClaritizerAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+void ClaritizerAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    process(buffer, floatChain);
+}
+
+void ClaritizerAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    process(buffer, doubleChain);
+}
+
+template <typename SampleType>
+void ClaritizerAudioProcessor::process(juce::AudioBuffer<SampleType>& buffer, ProcessingChain<SampleType>& chain)
+{
+    juce::ScopedNoDenormals noDenormals;
+    ScopedAllocationGuard allocationGuard;
+    ScopedStorageCheck wetStorageCheck(chain.wetBuffer), rampStorageCheck(clarityRamp);
+    ScopedBlockTimer blockTimer(profiler, buffer.getNumSamples());
+    
+    auto totalNumInputChannels = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear(i, 0, buffer.getNumSamples());
+
+    // Get parameter values
+    clarity.setTargetValue(clarityParam->load());
+    float toneValue = toneParam->load();
+    int mode = (int)(modeParam->load());
+    
+    // Get mode configuration
+    ModeConfig config = getModeConfig(mode);
+    engineOptions.read().applyTo(chain.engine);
+    
+    // The host tempo is read once per block and held while the host reports none
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition())
+            if (auto bpm = position->getBpm(); bpm.hasValue() && *bpm > 0.0)
+                hostBpm = *bpm;
+    
+    // One TIME value per block; the engine crossfades whenever it moves
+    timeScale.setTargetValue(getTargetTimeScale(config));
+    auto blockTimeScale = timeScale.skip(buffer.getNumSamples());
+    
+    syncDivisionOutOfReach = isSynced() && ! TempoSync::isReachable(config, hostBpm, getSyncDivision());
+    blockTimeScale = applyTempoSync(config, blockTimeScale);
+    
+    auto tailSeconds = ClaritizerEngine<float>::getTailLengthSeconds(config, blockTimeScale);
+    tailLengthSeconds = tailSeconds;
+    
+    // Once the input has been silent for twice the tail, everything still
+    // circulating is 120 dB down: skip the wet chain and pass the (silent)
+    // dry signal until the input comes back
+    auto wasSilentFor = silentInputSamples;
+    
+    if (isSilent(buffer, totalNumInputChannels))
+        silentInputSamples = juce::jmin(silentInputSamples + buffer.getNumSamples(), silenceCounterLimit);
+    else
+        silentInputSamples = 0;
+    
+    auto sleepAfterSamples = (2.0 * tailSeconds + sleepMarginSeconds) * getSampleRate();
+    
+    if (silentInputSamples > 0 && (double)wasSilentFor >= sleepAfterSamples)
+    {
+        clarity.skip(buffer.getNumSamples());
+        
+        for (int channel = 0; channel < totalNumInputChannels; ++channel)
+            buffer.applyGain(channel, 0, buffer.getNumSamples(), (SampleType)(1.0f - clarity.getCurrentValue()));
+        
+        return;
+    }
+    
+    // Hosts may exceed the block size announced in prepareToPlay, so larger
+    // buffers are worked through in slices the scratch storage can hold
+    auto& wetBuffer = chain.wetBuffer;
+    auto numWetChannels = juce::jmin(totalNumInputChannels, wetBuffer.getNumChannels());
+    auto sliceSize = wetBuffer.getNumSamples();
+    
+    if (sliceSize == 0)
+        return; // prepareToPlay hasn't run yet for this precision
+    
+    // Apply tone filter settings (smoothed inside the filter)
+    chain.toneFilter.setTone(toneValue);
+    
+    for (int start = 0; start < buffer.getNumSamples(); start += sliceSize)
+    {
+        auto numSamples = juce::jmin(sliceSize, buffer.getNumSamples() - start);
+        
+        // Copy the dry signal into the wet buffer
+        for (int channel = 0; channel < numWetChannels; ++channel)
+            wetBuffer.copyFrom(channel, 0, buffer, channel, start, numSamples);
+        
+        // Chorus -> parallel delays -> reverb, block by block
+        if (auto* oversampler = chain.oversampler.get())
+        {
+            auto wetBlock = juce::dsp::AudioBlock<SampleType>(wetBuffer)
+                                .getSubsetChannelBlock(0, (size_t)numWetChannels)
+                                .getSubBlock(0, (size_t)numSamples);
+            auto upsampled = oversampler->processSamplesUp(wetBlock);
+            
+            SampleType* upsampledChannels[ClaritizerEngine<SampleType>::maxChannels] = {};
+            
+            for (int channel = 0; channel < juce::jmin(numWetChannels, ClaritizerEngine<SampleType>::maxChannels); ++channel)
+                upsampledChannels[channel] = upsampled.getChannelPointer((size_t)channel);
+            
+            chain.engine.process(upsampledChannels, numWetChannels,
+                           (int)upsampled.getNumSamples(), config, blockTimeScale);
+            
+            oversampler->processSamplesDown(wetBlock);
+            
+            // Delay the dry signal by the same amount as the wet one
+            for (int channel = 0; channel < numWetChannels; ++channel)
+            {
+                auto* dryData = buffer.getWritePointer(channel, start);
+                
+                for (int sample = 0; sample < numSamples; ++sample)
+                {
+                    chain.dryDelay.pushSample(channel, dryData[sample]);
+                    dryData[sample] = chain.dryDelay.popSample(channel);
+                }
+            }
+        }
+        else
+        {
+            chain.engine.process(wetBuffer.getArrayOfWritePointers(), numWetChannels,
+                           numSamples, config, blockTimeScale);
+        }
+        
+        // Apply tone filter
+        {
+            ScopedStageTimer timer(&profiler, StageProfiler::toneFilterStage);
+            chain.toneFilter.process(wetBuffer.getArrayOfWritePointers(), numWetChannels, numSamples);
+        }
+        
+        ScopedStageTimer mixTimer(&profiler, StageProfiler::mixStage);
+        
+        // Clarity only gets a per-sample ramp while it is actually moving
+        auto clarityMoving = clarity.isSmoothing();
+        
+        if (clarityMoving)
+            for (int sample = 0; sample < numSamples; ++sample)
+                clarityRamp[sample] = clarity.getNextValue();
+        
+        auto dryWet = (SampleType)clarity.getCurrentValue();
+        
+        // Mix dry and wet with FINAL SAFETY LIMITING
+        for (int channel = 0; channel < numWetChannels; ++channel)
+        {
+            auto* dryData = buffer.getWritePointer(channel, start);
+            auto* wetData = wetBuffer.getReadPointer(channel);
+            
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                SampleType drySample = dryData[sample];
+                SampleType wetSample = wetData[sample];
+                SampleType wetAmount = clarityMoving ? (SampleType)clarityRamp[sample] : dryWet;
+                
+                SampleType output = drySample * ((SampleType)1 - wetAmount) + wetSample * wetAmount;
+                
+                // FINAL HARD LIMIT
+                output = juce::jlimit((SampleType)-1, (SampleType)1, output);
+                
+                dryData[sample] = output;
+            }
+        }
+    }
+}
+
+//==============================================================================
+// Oversampling - the factor and filter are fixed while the chain runs. A
+// parameter or realtime-state change that asks for a different oversampler
+// prepares the chain again on the message thread, which also reports the new
+// latency from there.
+//==============================================================================
+ClaritizerAudioProcessor::OversamplingChoice ClaritizerAudioProcessor::getOversamplingChoice(double sampleRate) const
+{
+    // Oversampling stops where the engine would run above maxOversampledRate
+    auto maxStages = 0;
+    
+    while (maxStages < numOversamplingStages && sampleRate * (2 << maxStages) <= maxOversampledRate)
+        ++maxStages;
+    
+    OversamplingChoice choice;
+    choice.stages = juce::jmin(juce::roundToInt(oversamplingParam->load()), maxStages);
+    
+    if (oversampleOfflineOnlyParam->load() >= 0.5f && ! isNonRealtime())
+        choice.stages = 0;
+    
+    // The filter makes no difference while oversampling is off
+    if (choice.stages > 0)
+        choice.filter = juce::roundToInt(oversamplingFilterParam->load());
+    
+    return choice;
+}
+
+void ClaritizerAudioProcessor::setNonRealtime(bool isNonRealtime) noexcept
+{
+    AudioProcessor::setNonRealtime(isNonRealtime);
+    triggerAsyncUpdate();
+}
+
+void ClaritizerAudioProcessor::parameterChanged(const juce::String&, float)
+{
+    triggerAsyncUpdate();
+}
+
+void ClaritizerAudioProcessor::handleAsyncUpdate()
+{
+    if (preparedBlockSize == 0 || getOversamplingChoice(preparedSampleRate) == preparedOversampling)
+        return;
+    
+    // Hosts hold the callback lock around processBlock, so once processing is
+    // suspended no block is running and none starts until it resumes
+    suspendProcessing(true);
+    prepareToPlay(preparedSampleRate, preparedBlockSize);
+    suspendProcessing(false);
+}
+
+bool ClaritizerAudioProcessor::hasEditor() const
+{
+    return true;
+}
+
+juce::AudioProcessorEditor* ClaritizerAudioProcessor::createEditor()
+{
+    return new ClaritizerAudioProcessorEditor(*this);
+}
+
+void ClaritizerAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    auto state = parameters.copyState();
+    std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    copyXmlToBinary(*xml, destData);
+}
+
+void ClaritizerAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+
+    if (xmlState.get() != nullptr)
+        if (xmlState->hasTagName(parameters.state.getType()))
+            parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+}
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new ClaritizerAudioProcessor();
+}
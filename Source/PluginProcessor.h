@@ -1,208 +1,188 @@
-#define JUCE_IGNORE_VST3_MISMATCHED_PARAMETER_ID_WARNING 1
-#define JUCE_VST3_CAN_REPLACE_VST2 0
-
-#pragma once
-
-#include <JuceHeader.h>
-
-//==============================================================================
-// Delay Line - Simple circular buffer with interpolation
-//==============================================================================
-class DelayLine
-{
-public:
-    void prepare(double sampleRate, float maxDelaySeconds)
-    {
-        int bufferSize = (int)(sampleRate * maxDelaySeconds) + 1;
-        buffer.setSize(1, bufferSize);
-        buffer.clear();
-        writePosition = 0;
-        this->sampleRate = sampleRate;
-    }
-    
-    void clear()
-    {
-        buffer.clear();
-        writePosition = 0;
-    }
-    
-    void writeSample(float sample)
-    {
-        buffer.setSample(0, writePosition, sample);
-        writePosition = (writePosition + 1) % buffer.getNumSamples();
-    }
-    
-    // Read with linear interpolation
-    float readSample(float delayInSamples)
-    {
-        float readPos = writePosition - delayInSamples;
-        while (readPos < 0)
-            readPos += buffer.getNumSamples();
-        
-        int readPos1 = (int)readPos;
-        int readPos2 = (readPos1 + 1) % buffer.getNumSamples();
-        float frac = readPos - readPos1;
-        
-        float sample1 = buffer.getSample(0, readPos1);
-        float sample2 = buffer.getSample(0, readPos2);
-        
-        return sample1 + frac * (sample2 - sample1);
-    }
-    
-private:
-    juce::AudioBuffer<float> buffer;
-    int writePosition = 0;
-    double sampleRate = 44100.0;
-};
-
-//==============================================================================
-// Simple LFO for modulation
-//==============================================================================
-class SimpleLFO
-{
-public:
-    void prepare(double sampleRate)
-    {
-        this->sampleRate = sampleRate;
-        phase = 0.0f;
-    }
-    
-    void setFrequency(float hz)
-    {
-        increment = (hz * juce::MathConstants<float>::twoPi) / (float)sampleRate;
-    }
-    
-    float getNextSample()
-    {
-        float value = std::sin(phase);
-        phase += increment;
-        if (phase >= juce::MathConstants<float>::twoPi)
-            phase -= juce::MathConstants<float>::twoPi;
-        return value;
-    }
-    
-private:
-    double sampleRate = 44100.0;
-    float phase = 0.0f;
-    float increment = 0.0f;
-};
-
-//==============================================================================
-class ClaritizerAudioProcessor : public juce::AudioProcessor
-{
-public:
-    ClaritizerAudioProcessor();
-    ~ClaritizerAudioProcessor() override;
-
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-    
-    // Chorus module configuration (series, pre-delays)
-    struct ChorusConfig
-    {
-        float timeMs;           // Chorus delay time (10-50ms typical)
-        float feedback;         // Light feedback (0.0-0.3)
-        float modDepth;         // LFO modulation depth in ms
-        float modRate;          // LFO rate in Hz
-        float mix;              // Chorus wet amount
-    };
-    
-    // Main delay configuration (parallel)
-    struct DelayConfig
-    {
-        float baseTimeMs;       // Base delay time (before TIME knob scaling)
-        float feedback;         // Feedback amount (0.0 - 0.95)
-        float modDepth;         // LFO modulation depth in ms
-        float modRate;          // LFO rate in Hz
-        float mix;              // Output mix (0.0 = muted, 1.0 = full)
-        bool reverse;           // Reverse delay effect (placeholder for now)
-    };
-    
-    // Reverb module configuration (series diffusion network, post-delays)
-    struct ReverbConfig
-    {
-        float delay1Time;       // First delay time in ms
-        float delay2Time;       // Second delay time in ms
-        float delay3Time;       // Third delay time in ms
-        float delay4Time;       // Fourth delay time in ms
-        float sharedFeedback;   // Shared feedback for all 4 delays
-        float mix;              // Reverb wet/dry mix
-    };
-    
-    // Complete mode configuration
-    struct ModeConfig
-    {
-        ChorusConfig chorus;
-        DelayConfig delay1;
-        DelayConfig delay2;
-        ReverbConfig reverb;
-    };
-
-    // Parameters
-    juce::AudioProcessorValueTreeState parameters;
-    
-    // Debug mode config overrides (set by editor)
-    ModeConfig debugModeConfigs[4];
-    bool useDebugConfigs = false;
-
-private:
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    
-    // Parameter pointers
-    std::atomic<float>* clarityParam = nullptr;
-    std::atomic<float>* timeParam = nullptr;
-    std::atomic<float>* toneParam = nullptr;
-    std::atomic<float>* modeParam = nullptr;
-
-    // Chorus module (stereo)
-    DelayLine chorusLeft, chorusRight;
-    SimpleLFO chorusLFOLeft, chorusLFORight;
-    
-    // 2 parallel main delays (stereo)
-    DelayLine delay1Left, delay1Right;
-    DelayLine delay2Left, delay2Right;
-    SimpleLFO lfo1Left, lfo1Right;
-    SimpleLFO lfo2Left, lfo2Right;
-    
-    // Reverb module - 4 series delays (stereo)
-    DelayLine reverb1Left, reverb1Right;
-    DelayLine reverb2Left, reverb2Right;
-    DelayLine reverb3Left, reverb3Right;
-    DelayLine reverb4Left, reverb4Right;
-    
-    // Tone filter
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                   juce::dsp::IIR::Coefficients<float>> toneFilter;
-    juce::dsp::ProcessSpec spec;
-
-    // Helper methods
-    ModeConfig getModeConfig(int mode);
-    float softClip(float sample);
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ClaritizerAudioProcessor)
-};
+#define JUCE_IGNORE_VST3_MISMATCHED_PARAMETER_ID_WARNING 1
+#define JUCE_VST3_CAN_REPLACE_VST2 0
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ModeConfig.h"
+#include "ClaritizerEngine.h"
+#include "ToneFilter.h"
+#include "TripleBuffer.h"
+#include "TempoSync.h"
+#include "AllocationTracker.h"
+#include "StageProfiler.h"
+#include "EngineOptions.h"
+
+//==============================================================================
+class ClaritizerAudioProcessor : public juce::AudioProcessor,
+                                 private juce::AudioProcessorValueTreeState::Listener,
+                                 private juce::AsyncUpdater
+{
+public:
+    ClaritizerAudioProcessor();
+    ~ClaritizerAudioProcessor() override;
+
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    void setNonRealtime (bool isNonRealtime) noexcept override;
+
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
+
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+    
+    // Parameters
+    juce::AudioProcessorValueTreeState parameters;
+    
+    // Debug mode config overrides. Called by the editor on the message
+    // thread; the audio thread picks the complete config up at its next block.
+    void setDebugModeConfig(int mode, const ModeConfig& config);
+    
+    static ModeConfig getDefaultModeConfig();
+    
+    // Engine choices that aren't parameters. The plugin runs the build's
+    // defaults (see EngineOptions.h); the command-line tools change them. Call
+    // from one thread at a time; the audio thread picks them up at its next block.
+    void setEngineOptions(const EngineOptions& options);
+    
+    // True while sync asks for a note division longer than the mode's delays
+    // can be at the host tempo; they play their longest time instead
+    bool isSyncDivisionOutOfReach() const noexcept { return syncDivisionOutOfReach; }
+    
+    // Audio thread time per stage, readable from any thread. Empty unless
+    // CLARITIZER_PROFILING is on.
+    const StageProfiler& getProfiler() const noexcept { return profiler; }
+
+private:
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    
+    // Parameter pointers
+    std::atomic<float>* clarityParam = nullptr;
+    std::atomic<float>* timeParam = nullptr;
+    std::atomic<float>* toneParam = nullptr;
+    std::atomic<float>* modeParam = nullptr;
+    std::atomic<float>* oversamplingParam = nullptr;
+    std::atomic<float>* oversamplingFilterParam = nullptr;
+    std::atomic<float>* oversampleOfflineOnlyParam = nullptr;
+    std::atomic<float>* syncParam = nullptr;
+    std::atomic<float>* syncDivisionParam = nullptr;
+
+    // Optional oversampling around the engine's delay/saturation core. Only
+    // the selected factor and filter are built, in prepareToPlay, with the
+    // engine's delay memory sized for that rate alone. Changing them suspends
+    // processing and prepares again from the message thread.
+    static constexpr int numOversamplingStages = 2;
+    static constexpr double maxOversampledRate = 192000.0;
+
+    struct OversamplingChoice
+    {
+        int stages = 0;             // 0 is off, 1 is 2x, 2 is 4x
+        int filter = 0;             // 0 is polyphase IIR, 1 is linear phase FIR
+
+        bool operator== (const OversamplingChoice& other) const noexcept
+        {
+            return stages == other.stages && filter == other.filter;
+        }
+    };
+
+    // What the chain was last prepared with; a block size of 0 means it isn't
+    OversamplingChoice preparedOversampling;
+    double preparedSampleRate = 0.0;
+    int preparedBlockSize = 0;
+    
+    // Everything that touches audio, in the host's sample type. Both chains
+    // exist, but only the one for the current precision is prepared, so a
+    // double-precision host gets no conversion copies and no float memory.
+    template <typename SampleType>
+    struct ProcessingChain
+    {
+        // Chorus, parallel delays and reverb
+        ClaritizerEngine<SampleType> engine;
+        
+        // Wet signal scratch, sized in prepareToPlay
+        juce::AudioBuffer<SampleType> wetBuffer;
+        
+        // Tone filter
+        ToneFilter<SampleType> toneFilter;
+        
+        // Null while oversampling is off
+        std::unique_ptr<juce::dsp::Oversampling<SampleType>> oversampler;
+        
+        // Keeps the dry signal in step with the oversampling latency
+        juce::dsp::DelayLine<SampleType, juce::dsp::DelayLineInterpolationTypes::None> dryDelay;
+    };
+    
+    ProcessingChain<float> floatChain;
+    ProcessingChain<double> doubleChain;
+    
+    // Dry/wet amount, smoothed per sample; the ramp is shared by all channels
+    juce::SmoothedValue<float> clarity;
+    juce::HeapBlock<float> clarityRamp;
+    
+    // TIME scale the engine runs at, from the knob or the host tempo. It
+    // glides per block so tempo changes turn into the engine's crossfades
+    // rather than jumps.
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> timeScale;
+    double hostBpm = TempoSync::defaultBpm;     // Last tempo the host reported
+    std::atomic<bool> syncDivisionOutOfReach { false };
+
+    // Tail reported to the host, refreshed every block
+    std::atomic<double> tailLengthSeconds { 0.0 };
+
+    // Consecutive samples of silent input, used to put the wet chain to sleep
+    int silentInputSamples = 0;
+
+    StageProfiler profiler;
+
+    // Debug overrides, one lock-free handoff per mode
+    std::array<TripleBuffer<ModeConfig>, 4> debugModeConfigs;
+    std::atomic<bool> useDebugConfigs { false };
+
+    // Engine options, handed over the same way
+    TripleBuffer<EngineOptions> engineOptions;
+
+    // Helper methods
+    ModeConfig getModeConfig(int mode);
+    float getTargetTimeScale(const ModeConfig& config) const;
+    bool isSynced() const;
+    int getSyncDivision() const;
+    float applyTempoSync(ModeConfig& config, float scale) const;
+    
+    OversamplingChoice getOversamplingChoice(double sampleRate) const;
+    
+    // Returns the latency of the chain's oversampling
+    template <typename SampleType>
+    int prepareChain(ProcessingChain<SampleType>& chain, double sampleRate, int samplesPerBlock, int numChannels);
+    
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, ProcessingChain<SampleType>& chain);
+
+    // Re-prepares when a change to the oversampling parameters or the
+    // realtime state asks for a different oversampler
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ClaritizerAudioProcessor)
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Simple LFO for modulation
+//
+// A rotating phasor instead of a sin() call per sample: each step multiplies
+// (cos, sin) by a fixed rotation, which yields the sine and its quadrature
+// partner for a couple of multiplies. Blocks are generated four phasors at a
+// time, each rotated by four steps, so the recurrence vectorises. The phasor is
+// renormalised once per block to stop its amplitude drifting.
+//==============================================================================
+template <typename SampleType>
+class SimpleLFO
+{
+public:
+    void prepare(double sampleRate)
+    {
+        this->sampleRate = sampleRate;
+        frequency = -1.0f;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        sinValue = 0;
+        cosValue = 1;
+    }
+
+    void setFrequency(float hz)
+    {
+        if (hz == frequency)
+            return;
+
+        frequency = hz;
+
+        auto increment = (hz * juce::MathConstants<double>::twoPi) / sampleRate;
+        rotationCos = (SampleType)std::cos(increment);
+        rotationSin = (SampleType)std::sin(increment);
+        blockRotationCos = (SampleType)std::cos(increment * numLanes);
+        blockRotationSin = (SampleType)std::sin(increment * numLanes);
+    }
+
+    bool isRunning() const noexcept { return frequency != 0.0f; }
+
+    SampleType getNextSample() noexcept
+    {
+        auto value = sinValue;
+        rotate(sinValue, cosValue, rotationCos, rotationSin);
+        return value;
+    }
+
+    // Fills sin(phase) for the next numSamples
+    void fill(SampleType* output, int numSamples) noexcept
+    {
+        fill(output, nullptr, numSamples);
+    }
+
+    // Fills sin(phase) and, if cosineOutput isn't null, cos(phase). Any other
+    // phase offset can be mixed from the two without another oscillator.
+    void fill(SampleType* sineOutput, SampleType* cosineOutput, int numSamples) noexcept
+    {
+        int i = 0;
+
+        if (numSamples >= numLanes)
+        {
+            // Lane k starts k steps ahead of the current phase
+            SampleType laneSin[numLanes], laneCos[numLanes];
+            laneSin[0] = sinValue;
+            laneCos[0] = cosValue;
+
+            for (int k = 1; k < numLanes; ++k)
+            {
+                laneSin[k] = laneSin[k - 1];
+                laneCos[k] = laneCos[k - 1];
+                rotate(laneSin[k], laneCos[k], rotationCos, rotationSin);
+            }
+
+            for (; i + numLanes <= numSamples; i += numLanes)
+            {
+                for (int k = 0; k < numLanes; ++k)
+                    sineOutput[i + k] = laneSin[k];
+
+                if (cosineOutput != nullptr)
+                    for (int k = 0; k < numLanes; ++k)
+                        cosineOutput[i + k] = laneCos[k];
+
+                for (int k = 0; k < numLanes; ++k)
+                    rotate(laneSin[k], laneCos[k], blockRotationCos, blockRotationSin);
+            }
+
+            sinValue = laneSin[0];
+            cosValue = laneCos[0];
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            sineOutput[i] = sinValue;
+
+            if (cosineOutput != nullptr)
+                cosineOutput[i] = cosValue;
+
+            rotate(sinValue, cosValue, rotationCos, rotationSin);
+        }
+
+        normalise();
+    }
+
+private:
+    static constexpr int numLanes = 4;
+
+    static void rotate(SampleType& s, SampleType& c, SampleType rotCos, SampleType rotSin) noexcept
+    {
+        auto newSin = s * rotCos + c * rotSin;
+        c = c * rotCos - s * rotSin;
+        s = newSin;
+    }
+
+    void normalise() noexcept
+    {
+        auto scale = (SampleType)1 / std::sqrt(sinValue * sinValue + cosValue * cosValue);
+        sinValue *= scale;
+        cosValue *= scale;
+    }
+
+    double sampleRate = 44100.0;
+    float frequency = -1.0f;
+    SampleType sinValue = 0, cosValue = 1;
+    SampleType rotationCos = 1, rotationSin = 0;
+    SampleType blockRotationCos = 1, blockRotationSin = 0;
+};
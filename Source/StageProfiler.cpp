@@ -0,0 +1,91 @@
+#include "StageProfiler.h"
+
+const char* StageProfiler::getStageName(int stage)
+{
+    switch (stage)
+    {
+        case chorusStage:     return "chorus";
+        case delaysStage:     return "delays";
+        case reverbStage:     return "reverb";
+        case toneFilterStage: return "tone filter";
+        case mixStage:        return "mix/limiter";
+        default:              return "";
+    }
+}
+
+//==============================================================================
+StageProfiler::Snapshot StageProfiler::Snapshot::operator- (const Snapshot& earlier) const noexcept
+{
+    Snapshot difference;
+
+    for (int stage = 0; stage < numStages; ++stage)
+        difference.stageTicks[stage] = stageTicks[stage] - earlier.stageTicks[stage];
+
+    difference.blockTicks = blockTicks - earlier.blockTicks;
+    difference.audioTicks = audioTicks - earlier.audioTicks;
+    return difference;
+}
+
+double StageProfiler::Snapshot::getLoad(int stage) const noexcept
+{
+    return audioTicks > 0 ? (double)stageTicks[stage] / (double)audioTicks : 0.0;
+}
+
+double StageProfiler::Snapshot::getBlockLoad() const noexcept
+{
+    return audioTicks > 0 ? (double)blockTicks / (double)audioTicks : 0.0;
+}
+
+double StageProfiler::Snapshot::getOtherLoad() const noexcept
+{
+    auto other = getBlockLoad();
+
+    for (int stage = 0; stage < numStages; ++stage)
+        other -= getLoad(stage);
+
+    return juce::jmax(0.0, other);
+}
+
+juce::String StageProfiler::Snapshot::toText() const
+{
+    auto ticksPerMillisecond = (double)juce::Time::getHighResolutionTicksPerSecond() / 1000.0;
+    juce::String text;
+
+    auto addLine = [&](const juce::String& name, double ticks, double load)
+    {
+        text << name.paddedRight(' ', 14)
+             << juce::String(ticks / ticksPerMillisecond, 2).paddedLeft(' ', 12) << " ms"
+             << juce::String(load * 100.0, 2).paddedLeft(' ', 10) << " % load" << juce::newLine;
+    };
+
+    text << "audio" << juce::String((double)audioTicks / ticksPerMillisecond, 2).paddedLeft(' ', 21) << " ms" << juce::newLine;
+
+    for (int stage = 0; stage < numStages; ++stage)
+        addLine(getStageName(stage), (double)stageTicks[stage], getLoad(stage));
+
+    addLine("other", getOtherLoad() * (double)audioTicks, getOtherLoad());
+    addLine("processBlock", (double)blockTicks, getBlockLoad());
+    return text;
+}
+
+//==============================================================================
+#if CLARITIZER_PROFILING
+
+void StageProfiler::prepare(double sampleRate) noexcept
+{
+    ticksPerSample = (double)juce::Time::getHighResolutionTicksPerSecond() / sampleRate;
+}
+
+StageProfiler::Snapshot StageProfiler::getSnapshot() const noexcept
+{
+    Snapshot snapshot;
+
+    for (int stage = 0; stage < numStages; ++stage)
+        snapshot.stageTicks[stage] = stageTicks[stage].load(std::memory_order_relaxed);
+
+    snapshot.blockTicks = blockTicks.load(std::memory_order_relaxed);
+    snapshot.audioTicks = audioTicks.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+#endif
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Stage Profiler - where the audio thread's time goes, stage by stage
+//
+// Each stage of processBlock adds the high-resolution ticks it took to its own
+// counter, and every block adds its total time and the length of audio it
+// covered. The counters are relaxed atomics, so the audio thread never waits
+// or allocates, and any other thread can take a snapshot at any time. The
+// difference between two snapshots gives each stage's load over that interval:
+// the time it took per second of audio, 1.0 being a whole core.
+//
+// The engine stages are timed per channel and sub-block, so the clock is read
+// a handful of times per 256 samples. Everything is compiled in only when
+// CLARITIZER_PROFILING is on (the default for debug builds, and set by the
+// command-line tools' Profile configuration); otherwise the timers are empty
+// and every snapshot reads zero.
+//==============================================================================
+#ifndef CLARITIZER_PROFILING
+ #if JUCE_DEBUG
+  #define CLARITIZER_PROFILING 1
+ #else
+  #define CLARITIZER_PROFILING 0
+ #endif
+#endif
+
+class StageProfiler
+{
+public:
+    enum Stage
+    {
+        chorusStage,
+        delaysStage,
+        reverbStage,
+        toneFilterStage,
+        mixStage,               // Dry/wet mix and the output limiter
+        numStages
+    };
+
+    static const char* getStageName(int stage);
+
+    // Totals since the profiler was created. The counters are read one by one,
+    // so a snapshot taken mid-block may be a stage or two out of step.
+    struct Snapshot
+    {
+        juce::int64 stageTicks[numStages] {};
+        juce::int64 blockTicks = 0;     // Whole blocks, stages included
+        juce::int64 audioTicks = 0;     // Length of the audio those blocks covered
+
+        Snapshot operator- (const Snapshot& earlier) const noexcept;
+
+        // Seconds spent per second of audio
+        double getLoad(int stage) const noexcept;
+        double getBlockLoad() const noexcept;
+
+        // Block time that no stage accounts for: copies, oversampling, setup
+        double getOtherLoad() const noexcept;
+
+        // One line per stage, for the command-line tools to write out
+        juce::String toText() const;
+    };
+
+   #if CLARITIZER_PROFILING
+    // Sets the rate blocks are converted to audio time at; counters carry on
+    void prepare(double sampleRate) noexcept;
+
+    void addStage(Stage stage, juce::int64 ticks) noexcept
+    {
+        stageTicks[stage].fetch_add(ticks, std::memory_order_relaxed);
+    }
+
+    void addBlock(int numSamples, juce::int64 ticks) noexcept
+    {
+        blockTicks.fetch_add(ticks, std::memory_order_relaxed);
+        audioTicks.fetch_add((juce::int64)(numSamples * ticksPerSample), std::memory_order_relaxed);
+    }
+
+    Snapshot getSnapshot() const noexcept;
+
+private:
+    std::atomic<juce::int64> stageTicks[numStages] {};
+    std::atomic<juce::int64> blockTicks { 0 };
+    std::atomic<juce::int64> audioTicks { 0 };
+    double ticksPerSample = 0.0;
+   #else
+    void prepare(double) noexcept {}
+    void addStage(Stage, juce::int64) noexcept {}
+    void addBlock(int, juce::int64) noexcept {}
+    Snapshot getSnapshot() const noexcept    { return {}; }
+   #endif
+};
+
+//==============================================================================
+// Adds the time until it goes out of scope to one stage. A null profiler is
+// allowed, so code that may run without one needs no checks of its own.
+class ScopedStageTimer
+{
+public:
+   #if CLARITIZER_PROFILING
+    ScopedStageTimer(StageProfiler* profilerToUse, StageProfiler::Stage stageToTime) noexcept
+        : profiler(profilerToUse), stage(stageToTime),
+          start(profilerToUse != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+    {
+    }
+
+    ~ScopedStageTimer() noexcept
+    {
+        if (profiler != nullptr)
+            profiler->addStage(stage, juce::Time::getHighResolutionTicks() - start);
+    }
+
+private:
+    StageProfiler* profiler;
+    StageProfiler::Stage stage;
+    juce::int64 start;
+   #else
+    ScopedStageTimer(StageProfiler*, StageProfiler::Stage) noexcept {}
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedStageTimer)
+};
+
+// Adds the time until it goes out of scope, and the audio it covered, as a block
+class ScopedBlockTimer
+{
+public:
+   #if CLARITIZER_PROFILING
+    ScopedBlockTimer(StageProfiler& profilerToUse, int numSamplesInBlock) noexcept
+        : profiler(profilerToUse), numSamples(numSamplesInBlock),
+          start(juce::Time::getHighResolutionTicks())
+    {
+    }
+
+    ~ScopedBlockTimer() noexcept
+    {
+        profiler.addBlock(numSamples, juce::Time::getHighResolutionTicks() - start);
+    }
+
+private:
+    StageProfiler& profiler;
+    int numSamples;
+    juce::int64 start;
+   #else
+    ScopedBlockTimer(StageProfiler&, int) noexcept {}
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedBlockTimer)
+};
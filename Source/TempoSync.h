@@ -0,0 +1,114 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ModeConfig.h"
+
+//==============================================================================
+// Tempo Sync - locks a mode's timing to the host tempo
+//
+// Both delays are set straight to the chosen note division. The chorus and
+// reverb have no beat to land on, so they follow the TIME scale that puts the
+// mode's main delay on the division, keeping the proportions the mode was
+// voiced with as far as the TIME range allows. A division longer than a delay
+// can be is played at its longest and reported, never folded onto a shorter
+// note.
+//==============================================================================
+struct TempoSync
+{
+    struct Division
+    {
+        const char* name;
+        double quarterNotes;    // Length in quarter notes (beats of a x/4 bar)
+    };
+
+    static constexpr Division divisions[] =
+    {
+        { "1/1",   4.0 },
+        { "1/2",   2.0 },       { "1/2.",  3.0 },       { "1/2T",  4.0 / 3.0 },
+        { "1/4",   1.0 },       { "1/4.",  1.5 },       { "1/4T",  2.0 / 3.0 },
+        { "1/8",   0.5 },       { "1/8.",  0.75 },      { "1/8T",  1.0 / 3.0 },
+        { "1/16",  0.25 },      { "1/16.", 0.375 },     { "1/16T", 1.0 / 6.0 },
+        { "1/32",  0.125 }
+    };
+
+    static constexpr int numDivisions = (int)(sizeof(divisions) / sizeof(divisions[0]));
+    static constexpr int defaultDivision = 4;   // 1/4
+    static constexpr double defaultBpm = 120.0;
+
+    static juce::StringArray getDivisionNames()
+    {
+        juce::StringArray names;
+
+        for (const auto& division : divisions)
+            names.add(division.name);
+
+        return names;
+    }
+
+    // The mode's timing is anchored on whichever delay is audible, delay 1 first
+    static float getReferenceTimeMs(const ModeConfig& config)
+    {
+        if (config.delay1.mix == 0.0f && config.delay2.mix != 0.0f && config.delay2.baseTimeMs > 0.0f)
+            return config.delay2.baseTimeMs;
+
+        return config.delay1.baseTimeMs > 0.0f ? config.delay1.baseTimeMs : 1.0f;
+    }
+
+    // Longest time a synced delay is set to: what the delay lines hold for
+    // the longest debug delay at full TIME, 6 s or a 1/1 at 40 bpm. A reverse
+    // delay reaches back three segments, so its segments are a third of that.
+    static constexpr double maxDelayMs = (double)ModeConfigLimits::maxDelayTimeMs * (double)ModeConfigLimits::maxTimeScale;
+
+    static double getMaxDelayMs(const DelayConfig& delay)
+    {
+        return delay.reverse ? maxDelayMs / 3.0 : maxDelayMs;
+    }
+
+    static double getDivisionMs(double bpm, int divisionIndex)
+    {
+        const auto& division = divisions[juce::jlimit(0, numDivisions - 1, divisionIndex)];
+        return 60000.0 / juce::jmax(bpm, 1.0) * division.quarterNotes;
+    }
+
+    // False when the division at this tempo is longer than an audible delay
+    // of the mode can be
+    static bool isReachable(const ModeConfig& config, double bpm, int divisionIndex)
+    {
+        auto divisionMs = getDivisionMs(bpm, divisionIndex);
+
+        for (const auto* delay : { &config.delay1, &config.delay2 })
+            if (delay->mix != 0.0f && divisionMs > getMaxDelayMs(*delay))
+                return false;
+
+        return true;
+    }
+
+    // TIME scale for the chorus and reverb: the one that puts the reference
+    // delay on the division, held inside the TIME range
+    static float getTimeScale(double bpm, int divisionIndex, float referenceTimeMs)
+    {
+        auto scale = getDivisionMs(bpm, divisionIndex) / (double)referenceTimeMs;
+
+        return (float)juce::jlimit((double)ModeConfigLimits::minTimeScale,
+                                   (double)ModeConfigLimits::maxTimeScale, scale);
+    }
+
+    // The mode retimed for sync, to run at a TIME scale of 1: both delays on
+    // the division and the chorus and reverb scaled by timeScale. Setting the
+    // delays outright keeps them still while the scale glides.
+    static ModeConfig retime(ModeConfig config, double bpm, int divisionIndex, float timeScale)
+    {
+        auto divisionMs = getDivisionMs(bpm, divisionIndex);
+
+        for (auto* delay : { &config.delay1, &config.delay2 })
+            delay->baseTimeMs = (float)juce::jmin(divisionMs, getMaxDelayMs(*delay));
+
+        config.chorus.timeMs *= timeScale;
+        config.reverb.delay1Time *= timeScale;
+        config.reverb.delay2Time *= timeScale;
+        config.reverb.delay3Time *= timeScale;
+        config.reverb.delay4Time *= timeScale;
+
+        return config;
+    }
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Tone Filter - smoothed low-pass on the wet signal
+//
+// A TPT state-variable filter (Q 0.7) whose cutoff follows the TONE knob from
+// 200 Hz to 18.2 kHz. The prewarped gain tan(pi * fc / fs) is tabulated over
+// the knob range in prepare(), so moving the knob costs a table lookup and one
+// division per sample instead of trig, and a knob that isn't moving costs no
+// coefficient work at all. The tone is smoothed per sample to avoid zipper
+// noise.
+//==============================================================================
+template <typename SampleType>
+class ToneFilter
+{
+public:
+    static constexpr float minCutoffHz = 200.0f;
+    static constexpr float cutoffRangeHz = 18000.0f;
+
+    void prepare(double sampleRate, int newNumChannels, float initialTone)
+    {
+        numChannels = newNumChannels;
+        state.calloc((size_t)(numChannels * 2));
+
+        // Keep the top of the range below Nyquist at low sample rates
+        auto maxCutoff = 0.45 * sampleRate;
+
+        for (int i = 0; i < tableSize; ++i)
+        {
+            auto cutoff = juce::jmin(maxCutoff, (double)(minCutoffHz + cutoffRangeHz * (float)i / (float)(tableSize - 1)));
+            gainTable[i] = (SampleType)std::tan(juce::MathConstants<double>::pi * cutoff / sampleRate);
+        }
+
+        gainTable[tableSize] = gainTable[tableSize - 1];
+
+        tone.reset(sampleRate, smoothingSeconds);
+        tone.setCurrentAndTargetValue(juce::jlimit(0.0f, 1.0f, initialTone));
+        updateCoefficients(tone.getCurrentValue());
+    }
+
+    void reset() noexcept
+    {
+        juce::FloatVectorOperations::clear(state.get(), numChannels * 2);
+        tone.setCurrentAndTargetValue(tone.getTargetValue());
+        updateCoefficients(tone.getCurrentValue());
+    }
+
+    // TONE knob position, 0 - 1
+    void setTone(float newTone) noexcept
+    {
+        tone.setTargetValue(juce::jlimit(0.0f, 1.0f, newTone));
+    }
+
+    void process(SampleType* const* channelData, int numChannelsToProcess, int numSamples) noexcept
+    {
+        numChannelsToProcess = juce::jmin(numChannelsToProcess, numChannels);
+
+        if (! tone.isSmoothing())
+        {
+            for (int channel = 0; channel < numChannelsToProcess; ++channel)
+            {
+                auto& ic1 = state[channel * 2];
+                auto& ic2 = state[channel * 2 + 1];
+                auto* data = channelData[channel];
+
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = processSample(data[i], ic1, ic2);
+            }
+
+            return;
+        }
+
+        // The cutoff moves every sample, so all channels advance together
+        for (int i = 0; i < numSamples; ++i)
+        {
+            updateCoefficients(tone.getNextValue());
+
+            for (int channel = 0; channel < numChannelsToProcess; ++channel)
+                channelData[channel][i] = processSample(channelData[channel][i],
+                                                       state[channel * 2], state[channel * 2 + 1]);
+        }
+    }
+
+private:
+    static constexpr int tableSize = 512;
+    static constexpr double smoothingSeconds = 0.05;
+    static constexpr SampleType damping = (SampleType)(1.0 / 0.7);   // k = 1 / Q
+
+    SampleType processSample(SampleType input, SampleType& ic1, SampleType& ic2) const noexcept
+    {
+        auto v3 = input - ic2;
+        auto v1 = a1 * ic1 + a2 * v3;
+        auto v2 = ic2 + a2 * ic1 + a3 * v3;
+        ic1 = (SampleType)2 * v1 - ic1;
+        ic2 = (SampleType)2 * v2 - ic2;
+        return v2;
+    }
+
+    void updateCoefficients(float toneValue) noexcept
+    {
+        auto position = toneValue * (float)(tableSize - 1);
+        auto index = juce::jmin((int)position, tableSize - 1);
+        auto frac = (SampleType)(position - (float)index);
+        auto g = gainTable[index] + frac * (gainTable[index + 1] - gainTable[index]);
+
+        a1 = (SampleType)1 / ((SampleType)1 + g * (g + damping));
+        a2 = g * a1;
+        a3 = g * a2;
+    }
+
+    SampleType gainTable[tableSize + 1] = {};
+    juce::SmoothedValue<float> tone;
+    SampleType a1 = 1, a2 = 0, a3 = 0;
+
+    juce::HeapBlock<SampleType> state;   // ic1, ic2 per channel
+    int numChannels = 0;
+};
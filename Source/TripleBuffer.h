@@ -0,0 +1,61 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Triple Buffer - lock-free handoff of a value from one writer to one reader
+//
+// The writer fills its private slot and swaps it with the shared middle slot;
+// the reader swaps the middle slot for its own whenever something new has been
+// published. Neither side ever waits or sees a half-written value, and a burst
+// of writes between two reads collapses into the newest one.
+//==============================================================================
+template <typename Type>
+class TripleBuffer
+{
+public:
+    // Not thread-safe: only for setting the initial value before both sides run
+    void reset(const Type& value)
+    {
+        for (auto& buffer : buffers)
+            buffer = value;
+
+        writeIndex = 0;
+        middle.store(1);
+        readIndex = 2;
+    }
+
+    //==========================================================================
+    // Writer thread
+    void write(const Type& value) noexcept
+    {
+        buffers[(size_t)writeIndex] = value;
+
+        auto previous = middle.exchange(writeIndex | newDataFlag, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+
+    //==========================================================================
+    // Reader thread - returns the most recently published value
+    const Type& read() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & newDataFlag) != 0)
+        {
+            auto previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+            readIndex = previous & indexMask;
+        }
+
+        return buffers[(size_t)readIndex];
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newDataFlag = 4;
+
+    std::array<Type, 3> buffers {};
+    std::atomic<int> middle { 1 };
+    int writeIndex = 0;
+    int readIndex = 2;
+
+    static_assert(std::atomic<int>::is_always_lock_free, "The handoff must not take a lock");
+};
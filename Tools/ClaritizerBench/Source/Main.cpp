@@ -0,0 +1,741 @@
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include <iostream>
+
+//==============================================================================
+// Claritizer Bench - benchmark suite for the DSP building blocks and the plugin
+//
+//   ClaritizerBench [--json <file>] [--label <text>] [--quick] [--profile <file>]
+//                   [--interpolation <[module=]modulated[/fixed]>]
+//                   [--saturation <[module=]softclip|adaa>]
+//   ClaritizerBench --check
+//
+// Every benchmark reports nanoseconds per sample and channel, and the
+// real-time factor: seconds of audio processed per second of CPU time. Each
+// number is the best of several runs, so one scheduler hiccup doesn't decide
+// the result. The suite covers:
+//   - delay line: every interpolation, fixed and modulated
+//   - LFO: sine, and sine with its quadrature partner
+//   - saturators: CPU on a sine driven well past the knee, and aliasing of a
+//     4999 Hz sine at several drives, as the power of everything that isn't a
+//     harmonic relative to the harmonics
+//   - tone filter: stereo
+//   - engine: the whole wet chain in float and double, as set up by the
+//     options below and again with the ADAA saturator in every module
+//   - processBlock: the plugin itself, every mode with modulation off and on,
+//     over sample rates from 44.1 to 192 kHz and host blocks of 32 to 4096
+//
+// The building blocks run in 256-sample blocks like the engine's sub-blocks,
+// at every sample rate where the rate changes what they do. The oversampled
+// saturators wrap the plain soft clip in the same polyphase IIR oversampler
+// the plugin offers, so they compare directly with the saturation options.
+//
+// --json writes every result to one file, tagged with --label (e.g. a commit
+// hash), so runs can be compared between commits. --quick cuts the
+// processBlock sweep down to 48 kHz and three block sizes. Built in the
+// Profile configuration, the processBlock results also carry the plugin's own
+// per-stage load, and --profile writes that breakdown for the whole sweep to a
+// text file; Release leaves the timers out so they don't skew the timings.
+// --interpolation and --saturation pick the delay interpolation and feedback
+// saturator the engine and processBlock run with, for one module or all of
+// them, as ClaritizerRender takes them; both can be repeated.
+//
+// Every run starts with the accuracy checks: the soft clip's tanh and whole
+// curve against std::tanh, and the ADAA saturator's continuity where it
+// switches to the midpoint, each held to the bound its header documents.
+// --check runs only those. A failed check makes the exit code 1.
+//==============================================================================
+namespace
+{
+    constexpr double defaultSampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int runs = 5;
+
+    const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+    const int hostBlockSizes[] = { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+
+    //==========================================================================
+    // Every measurement of a run, printed as it comes in and kept for the JSON
+    class Results
+    {
+    public:
+        // Returns the entry so the caller can attach what it swept over
+        juce::DynamicObject& add(const juce::String& benchmark, const juce::String& variant,
+                                 double sampleRate, int numChannels, double nanosecondsPerSample)
+        {
+            auto realtimeFactor = 1.0e9 / (nanosecondsPerSample * sampleRate * numChannels);
+
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("benchmark", benchmark);
+            entry->setProperty("variant", variant);
+            entry->setProperty("sampleRate", sampleRate);
+            entry->setProperty("channels", numChannels);
+            entry->setProperty("nsPerSample", nanosecondsPerSample);
+            entry->setProperty("realtimeFactor", realtimeFactor);
+            entries.add(juce::var(entry));
+
+            std::cout << benchmark.paddedRight(' ', 14) << variant.paddedRight(' ', 34)
+                      << juce::String(sampleRate / 1000.0, 1).paddedLeft(' ', 7) << " kHz"
+                      << juce::String(nanosecondsPerSample, 2).paddedLeft(' ', 10) << " ns"
+                      << juce::String(realtimeFactor, 1).paddedLeft(' ', 10) << "x" << std::endl;
+
+            return *entry;
+        }
+
+        bool writeJson(const juce::File& file, const juce::String& label) const
+        {
+            auto* root = new juce::DynamicObject();
+            root->setProperty("label", label);
+            root->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+            root->setProperty("cpu", juce::SystemStats::getCpuModel());
+            root->setProperty("os", juce::SystemStats::getOperatingSystemName());
+            root->setProperty("results", entries);
+            root->setProperty("checks", checks);
+
+            return file.replaceWithText(juce::JSON::toString(juce::var(root)));
+        }
+
+        // Returns whether error is within bound
+        bool addCheck(const juce::String& check, const juce::String& variant, double error, double bound)
+        {
+            auto passed = error <= bound;
+
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("check", check);
+            entry->setProperty("variant", variant);
+            entry->setProperty("error", error);
+            entry->setProperty("bound", bound);
+            entry->setProperty("passed", passed);
+            checks.add(juce::var(entry));
+
+            std::cout << check.paddedRight(' ', 14) << variant.paddedRight(' ', 34)
+                      << juce::String(error, 3, true).paddedLeft(' ', 12) << " <= "
+                      << juce::String(bound, 3, true).paddedRight(' ', 10)
+                      << (passed ? "ok" : "FAILED") << std::endl;
+
+            return passed;
+        }
+
+    private:
+        juce::Array<juce::var> entries, checks;
+    };
+
+    //==========================================================================
+    // Best time of several runs of body, in nanoseconds per sample it processes
+    template <typename Reset, typename Body>
+    double measureNanosecondsPerSample(int samplesPerRun, Reset&& reset, Body&& body)
+    {
+        auto best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < runs; ++run)
+        {
+            reset();
+            auto start = juce::Time::getHighResolutionTicks();
+
+            body();
+
+            auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            best = juce::jmin(best, seconds);
+        }
+
+        return best * 1.0e9 / (double)samplesPerRun;
+    }
+
+    template <typename SampleType>
+    void fillNoise(juce::AudioBuffer<SampleType>& buffer, float amplitude)
+    {
+        juce::Random random(1);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(channel, i, (SampleType)(amplitude * (random.nextFloat() * 2.0f - 1.0f)));
+    }
+
+    void fillSine(std::vector<float>& data, double frequency, float amplitude)
+    {
+        auto increment = juce::MathConstants<double>::twoPi * frequency / defaultSampleRate;
+
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = amplitude * (float)std::sin(increment * (double)i);
+    }
+
+    //==========================================================================
+    // ACCURACY
+    //==========================================================================
+    // SoftClip's curve with std::tanh in place of the approximant
+    double exactSoftClip(double x)
+    {
+        constexpr auto knee = (double)SoftClip::knee;
+        constexpr auto range = (double)SoftClip::ceiling - knee;
+
+        auto magnitude = std::abs(x);
+        return std::copysign(juce::jmin(magnitude, knee) + range * std::tanh(juce::jmax(magnitude - knee, 0.0) / range), x);
+    }
+
+    // Largest difference between approximation and exact over [-limit, limit]
+    template <typename SampleType, typename Approximation, typename Exact>
+    double measureMaxError(double limit, Approximation&& approximation, Exact&& exact)
+    {
+        constexpr int numPoints = 1 << 20;
+        auto maxError = 0.0;
+
+        for (int i = 0; i <= numPoints; ++i)
+        {
+            auto x = (SampleType)(limit * (2.0 * i / numPoints - 1.0));
+            maxError = juce::jmax(maxError, std::abs((double)approximation(x) - exact((double)x)));
+        }
+
+        return maxError;
+    }
+
+    // Largest jump in the ADAA output, beyond the input's own step, as the step
+    // from x[n-1] sweeps through the length where the midpoint takes over. The
+    // curve's slope is at most 1, so a continuous output moves no further than
+    // its input does.
+    template <typename SampleType>
+    double measureAntialiasedSwitchJump()
+    {
+        constexpr int stepsPerSide = 4096;
+        constexpr double sweep = 4.0e-5;    // Well past the switch on both sides
+        auto maxJump = 0.0;
+
+        for (auto previousInput : { 0.0, 0.5, 0.9, 1.0, 1.2, 1.5, 2.0, -0.95, -1.4 })
+        {
+            auto lastInput = 0.0, lastOutput = 0.0;
+
+            for (int i = -stepsPerSide; i <= stepsPerSide; ++i)
+            {
+                auto previous = (SampleType)previousInput;
+                auto sample = (SampleType)(previousInput + sweep * i / stepsPerSide);
+                auto input = (double)sample;
+
+                AntialiasedSoftClip::process(&sample, 1, previous);
+
+                if (i > -stepsPerSide)
+                    maxJump = juce::jmax(maxJump, std::abs((double)sample - lastOutput) - std::abs(input - lastInput));
+
+                lastInput = input;
+                lastOutput = (double)sample;
+            }
+        }
+
+        return maxJump;
+    }
+
+    template <typename SampleType>
+    bool runAccuracyChecks(Results& results, const juce::String& precision)
+    {
+        auto fastTanh = [](SampleType x) { return SoftClip::fastTanh(x); };
+        auto softClip = [](SampleType x) { return SoftClip::processSample(x); };
+        auto exactTanh = [](double x) { return std::tanh(x); };
+
+        auto passed = results.addCheck("softClip", "tanh, " + precision,
+                                       measureMaxError<SampleType>(8.0, fastTanh, exactTanh), SoftClip::maxTanhError);
+
+        passed &= results.addCheck("softClip", "curve, " + precision,
+                                   measureMaxError<SampleType>(8.0, softClip, exactSoftClip), SoftClip::maxCurveError);
+
+        passed &= results.addCheck("ADAA softClip", "midpoint switch, " + precision,
+                                   measureAntialiasedSwitchJump<SampleType>(), AntialiasedSoftClip::maxSwitchJump);
+
+        return passed;
+    }
+
+    bool runAccuracyChecks(Results& results)
+    {
+        auto floatPassed = runAccuracyChecks<float>(results, "float");
+        auto doublePassed = runAccuracyChecks<double>(results, "double");
+        return floatPassed && doublePassed;
+    }
+
+    //==========================================================================
+    // DELAY LINE
+    //==========================================================================
+    // Reads and writes of a quarter-second line, the delay swinging by 20
+    // samples when modulated
+    double measureDelayLine(double sampleRate, DelayInterpolation interpolation, bool modulated)
+    {
+        auto numSamples = blockSize * 256;
+
+        DelayBank<float> bank;
+        const float maxDelaySeconds[] = { 0.5f };
+        bank.prepare(sampleRate, 1, maxDelaySeconds, 1);
+
+        auto line = bank.getLine(0, 0);
+        auto delay = (float)(sampleRate * 0.25);
+
+        juce::AudioBuffer<float> input(1, numSamples);
+        fillNoise(input, 0.5f);
+
+        std::vector<float> output((size_t)blockSize), delayTimes((size_t)blockSize);
+
+        for (size_t i = 0; i < delayTimes.size(); ++i)
+            delayTimes[i] = delay + 20.0f * std::sin((float)i * 0.01f);
+
+        return measureNanosecondsPerSample(numSamples, [&] { bank.clear(); line.setParameters(delay, 0.0f); }, [&]
+        {
+            for (int offset = 0; offset < numSamples; offset += blockSize)
+            {
+                line.beginBlock();
+
+                if (modulated)
+                    line.readModulated(delayTimes.data(), output.data(), blockSize, interpolation);
+                else
+                    line.read(delay, output.data(), blockSize, interpolation);
+
+                line.write(input.getReadPointer(0, offset), blockSize);
+            }
+        });
+    }
+
+    void runDelayLineBenchmarks(Results& results)
+    {
+        for (auto sampleRate : sampleRates)
+        {
+            for (auto interpolation : { DelayInterpolation::linear, DelayInterpolation::hermite,
+                                        DelayInterpolation::lagrange3, DelayInterpolation::allpass })
+            {
+                juce::String name = EngineOptions::getInterpolationName(interpolation);
+                results.add("delayLine", name + " fixed", sampleRate, 1, measureDelayLine(sampleRate, interpolation, false));
+
+                // The allpass can't follow a moving delay
+                if (interpolation != DelayInterpolation::allpass)
+                    results.add("delayLine", name + " modulated", sampleRate, 1, measureDelayLine(sampleRate, interpolation, true));
+            }
+        }
+    }
+
+    //==========================================================================
+    // LFO
+    //==========================================================================
+    void runLfoBenchmarks(Results& results)
+    {
+        auto numSamples = blockSize * 1024;
+
+        for (auto quadrature : { false, true })
+        {
+            SimpleLFO<float> lfo;
+            std::vector<float> sine((size_t)blockSize), cosine((size_t)blockSize);
+
+            auto nanoseconds = measureNanosecondsPerSample(numSamples, [&]
+            {
+                lfo.prepare(defaultSampleRate);
+                lfo.setFrequency(0.7f);
+            }, [&]
+            {
+                for (int offset = 0; offset < numSamples; offset += blockSize)
+                    lfo.fill(sine.data(), quadrature ? cosine.data() : nullptr, blockSize);
+            });
+
+            results.add("lfo", quadrature ? "sine + cosine" : "sine", defaultSampleRate, 1, nanoseconds);
+        }
+    }
+
+    //==========================================================================
+    // SATURATORS
+    //==========================================================================
+    struct Saturator
+    {
+        virtual ~Saturator() = default;
+        virtual juce::String getName() const = 0;
+        virtual void reset() = 0;
+        virtual void process(float* data, int numSamples) = 0;
+    };
+
+    struct PlainSoftClip : Saturator
+    {
+        juce::String getName() const override    { return "softClip"; }
+        void reset() override                     {}
+        void process(float* data, int numSamples) override { SoftClip::process(data, numSamples); }
+    };
+
+    struct AntialiasedSaturator : Saturator
+    {
+        juce::String getName() const override    { return "ADAA softClip"; }
+        void reset() override                     { previousInput = 0.0f; }
+
+        void process(float* data, int numSamples) override
+        {
+            AntialiasedSoftClip::process(data, numSamples, previousInput);
+        }
+
+        float previousInput = 0.0f;
+    };
+
+    struct OversampledSoftClip : Saturator
+    {
+        explicit OversampledSoftClip(int numStages)
+            : factor(1 << numStages),
+              oversampler(1, (size_t)numStages, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true)
+        {
+            oversampler.initProcessing((size_t)blockSize);
+        }
+
+        juce::String getName() const override    { return "softClip " + juce::String(factor) + "x IIR"; }
+        void reset() override                     { oversampler.reset(); }
+
+        void process(float* data, int numSamples) override
+        {
+            float* channels[] = { data };
+            juce::dsp::AudioBlock<float> block(channels, 1, (size_t)numSamples);
+
+            auto upsampled = oversampler.processSamplesUp(block);
+            SoftClip::process(upsampled.getChannelPointer(0), (int)upsampled.getNumSamples());
+            oversampler.processSamplesDown(block);
+        }
+
+        int factor;
+        juce::dsp::Oversampling<float> oversampler;
+    };
+
+    void processInBlocks(Saturator& saturator, float* data, int numSamples)
+    {
+        for (int start = 0; start < numSamples; start += blockSize)
+            saturator.process(data + start, juce::jmin(blockSize, numSamples - start));
+    }
+
+    double measureSaturator(Saturator& saturator)
+    {
+        constexpr int numSamples = blockSize * 64;
+        constexpr int repeats = 100;
+
+        std::vector<float> source((size_t)numSamples), data((size_t)numSamples);
+        fillSine(source, 997.0, 2.5f);
+
+        return measureNanosecondsPerSample(numSamples * repeats, [&] { saturator.reset(); }, [&]
+        {
+            for (int i = 0; i < repeats; ++i)
+            {
+                std::copy(source.begin(), source.end(), data.begin());
+                processInBlocks(saturator, data.data(), numSamples);
+            }
+        });
+    }
+
+    // Power outside the harmonics of the test tone relative to the harmonics
+    double measureAliasingDecibels(Saturator& saturator, float amplitude)
+    {
+        constexpr int fftOrder = 16;
+        constexpr int fftSize = 1 << fftOrder;
+        constexpr int warmUp = 8192;    // Lets the oversampling filters settle
+        constexpr double frequency = 4999.0;
+        constexpr int harmonicWidthBins = 6;
+
+        std::vector<float> data((size_t)(warmUp + fftSize));
+        fillSine(data, frequency, amplitude);
+
+        saturator.reset();
+        processInBlocks(saturator, data.data(), (int)data.size());
+
+        std::vector<float> spectrum((size_t)fftSize * 2, 0.0f);
+        std::copy(data.begin() + warmUp, data.end(), spectrum.begin());
+
+        juce::dsp::WindowingFunction<float> window((size_t)fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris, false);
+        window.multiplyWithWindowingTable(spectrum.data(), (size_t)fftSize);
+
+        juce::dsp::FFT fft(fftOrder);
+        fft.performFrequencyOnlyForwardTransform(spectrum.data());
+
+        auto binWidth = defaultSampleRate / fftSize;
+        double harmonicPower = 0.0, aliasPower = 0.0;
+
+        for (int bin = 1; bin < fftSize / 2; ++bin)
+        {
+            auto binFrequency = bin * binWidth;
+            auto nearestHarmonic = juce::jmax(1.0, std::round(binFrequency / frequency)) * frequency;
+            auto isHarmonic = nearestHarmonic < defaultSampleRate * 0.5
+                           && std::abs(binFrequency - nearestHarmonic) <= harmonicWidthBins * binWidth;
+
+            auto power = (double)spectrum[(size_t)bin] * (double)spectrum[(size_t)bin];
+            (isHarmonic ? harmonicPower : aliasPower) += power;
+        }
+
+        return 10.0 * std::log10(juce::jmax(aliasPower, 1.0e-30) / harmonicPower);
+    }
+
+    void runSaturatorBenchmarks(Results& results)
+    {
+        std::vector<std::unique_ptr<Saturator>> saturators;
+        saturators.push_back(std::make_unique<PlainSoftClip>());
+        saturators.push_back(std::make_unique<AntialiasedSaturator>());
+        saturators.push_back(std::make_unique<OversampledSoftClip>(1));
+        saturators.push_back(std::make_unique<OversampledSoftClip>(2));
+
+        const float drives[] = { 1.0f, 2.0f, 4.0f };
+
+        for (auto& saturator : saturators)
+        {
+            auto& entry = results.add("saturator", saturator->getName(), defaultSampleRate, 1, measureSaturator(*saturator));
+            juce::String aliasing;
+
+            for (auto drive : drives)
+            {
+                auto decibels = measureAliasingDecibels(*saturator, drive);
+                entry.setProperty("aliasingDb@" + juce::String(drive, 1), decibels);
+                aliasing << "  alias @" << juce::String(drive, 1) << ": " << juce::String(decibels, 1) << " dB";
+            }
+
+            std::cout << juce::String().paddedRight(' ', 14) << aliasing << std::endl;
+        }
+    }
+
+    //==========================================================================
+    // TONE FILTER
+    //==========================================================================
+    void runToneFilterBenchmarks(Results& results)
+    {
+        constexpr int numChannels = 2;
+        auto numSamples = blockSize * 256;
+
+        juce::AudioBuffer<float> source(numChannels, numSamples), data(numChannels, numSamples);
+        fillNoise(source, 0.5f);
+
+        for (auto sampleRate : sampleRates)
+        {
+            ToneFilter<float> filter;
+
+            auto nanoseconds = measureNanosecondsPerSample(numSamples * numChannels, [&]
+            {
+                filter.prepare(sampleRate, numChannels, 0.3f);
+                data.makeCopyOf(source, true);
+            }, [&]
+            {
+                for (int offset = 0; offset < numSamples; offset += blockSize)
+                {
+                    float* channels[] = { data.getWritePointer(0, offset), data.getWritePointer(1, offset) };
+                    filter.process(channels, numChannels, blockSize);
+                }
+            });
+
+            results.add("toneFilter", "stereo", sampleRate, numChannels, nanoseconds);
+        }
+    }
+
+    //==========================================================================
+    // ENGINE
+    //==========================================================================
+    // Every module active and modulated, so nothing in the engine is skipped
+    ModeConfig makeFullConfig()
+    {
+        ModeConfig config;
+        config.chorus = { 20.0f, 0.2f, 2.0f, 0.8f, 0.5f, 90.0f };
+        config.delay1 = { 250.0f, 0.5f, 1.0f, 0.3f, 1.0f, false, 30.0f };
+        config.delay2 = { 375.0f, 0.4f, 0.0f, 0.0f, 0.6f, false };
+        config.reverb = { 37.0f, 83.0f, 127.0f, 211.0f, 0.8f, 0.4f };
+        return config;
+    }
+
+    template <typename SampleType>
+    double measureEngine(const ModeConfig& config, const EngineOptions& options)
+    {
+        constexpr int numChannels = 2;
+        constexpr int numSamples = 48000;
+        constexpr int hostBlockSize = 512;
+
+        auto engine = std::make_unique<ClaritizerEngine<SampleType>>();
+        engine->prepare(defaultSampleRate, numChannels);
+        options.applyTo(*engine);
+
+        juce::AudioBuffer<SampleType> source(numChannels, numSamples), data(numChannels, numSamples);
+        fillNoise(source, 0.5f);
+
+        return measureNanosecondsPerSample(numSamples * numChannels, [&]
+        {
+            engine->reset();
+            data.makeCopyOf(source, true);
+        }, [&]
+        {
+            for (int offset = 0; offset < numSamples; offset += hostBlockSize)
+            {
+                SampleType* channels[] = { data.getWritePointer(0, offset), data.getWritePointer(1, offset) };
+                engine->process(channels, numChannels, juce::jmin(hostBlockSize, numSamples - offset), config, 1.0f);
+            }
+        });
+    }
+
+    void runEngineBenchmarks(Results& results, const EngineOptions& options)
+    {
+        auto config = makeFullConfig();
+        results.add("engine", "float, all modules", defaultSampleRate, 2, measureEngine<float>(config, options));
+        results.add("engine", "double, all modules", defaultSampleRate, 2, measureEngine<double>(config, options));
+
+        auto antialiased = options;
+        antialiased.saturation.fill(SaturationMode::antialiased);
+        results.add("engine", "float, all modules, ADAA", defaultSampleRate, 2, measureEngine<float>(config, antialiased));
+        results.add("engine", "double, all modules, ADAA", defaultSampleRate, 2, measureEngine<double>(config, antialiased));
+    }
+
+    //==========================================================================
+    // PROCESS BLOCK
+    //==========================================================================
+    // The mode's own settings, with the LFO turned up on both delays
+    ModeConfig makeModulatedConfig()
+    {
+        auto config = ClaritizerAudioProcessor::getDefaultModeConfig();
+        config.delay1.modDepth = config.delay2.modDepth = 1.0f;
+        config.delay1.modRate = config.delay2.modRate = 0.5f;
+        return config;
+    }
+
+    double measureProcessBlock(ClaritizerAudioProcessor& processor, double sampleRate, int hostBlockSize,
+                               int mode, bool modulation)
+    {
+        auto numChannels = processor.getTotalNumOutputChannels();
+        auto numSamples = (int)sampleRate;     // One second of audio
+
+        auto config = modulation ? makeModulatedConfig() : ClaritizerAudioProcessor::getDefaultModeConfig();
+        processor.setDebugModeConfig(mode, config);
+
+        if (auto* parameter = processor.parameters.getParameter("mode"))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1((float)mode));
+
+        juce::AudioBuffer<float> source(numChannels, numSamples), data(numChannels, numSamples);
+        fillNoise(source, 0.5f);
+        juce::MidiBuffer midi;
+
+        return measureNanosecondsPerSample(numSamples * numChannels, [&]
+        {
+            processor.setRateAndBufferSizeDetails(sampleRate, hostBlockSize);
+            processor.prepareToPlay(sampleRate, hostBlockSize);
+            data.makeCopyOf(source, true);
+        }, [&]
+        {
+            for (int offset = 0; offset < numSamples; offset += hostBlockSize)
+            {
+                juce::AudioBuffer<float> block(data.getArrayOfWritePointers(), numChannels, offset,
+                                               juce::jmin(hostBlockSize, numSamples - offset));
+                processor.processBlock(block, midi);
+            }
+        });
+    }
+
+    // Returns where processBlock spent its time over the whole sweep
+    StageProfiler::Snapshot runProcessBlockBenchmarks(Results& results, bool quick, const EngineOptions& options)
+    {
+        ClaritizerAudioProcessor processor;
+        processor.setEngineOptions(options);
+
+        for (auto sampleRate : sampleRates)
+        {
+            if (quick && sampleRate != defaultSampleRate)
+                continue;
+
+            for (auto hostBlockSize : hostBlockSizes)
+            {
+                if (quick && hostBlockSize != 64 && hostBlockSize != 512 && hostBlockSize != 4096)
+                    continue;
+
+                for (int mode = 0; mode < 4; ++mode)
+                {
+                    for (auto modulation : { false, true })
+                    {
+                        auto variant = "mode " + juce::String::charToString((juce::juce_wchar)('A' + mode))
+                                     + ", block " + juce::String(hostBlockSize)
+                                     + (modulation ? ", modulated" : "");
+
+                        auto profileStart = processor.getProfiler().getSnapshot();
+                        auto nanoseconds = measureProcessBlock(processor, sampleRate, hostBlockSize, mode, modulation);
+                        auto profile = processor.getProfiler().getSnapshot() - profileStart;
+                        auto& entry = results.add("processBlock", variant, sampleRate,
+                                                  processor.getTotalNumOutputChannels(), nanoseconds);
+                        entry.setProperty("blockSize", hostBlockSize);
+                        entry.setProperty("mode", mode);
+                        entry.setProperty("modulation", modulation);
+
+                       #if CLARITIZER_PROFILING
+                        auto* stageLoads = new juce::DynamicObject();
+
+                        for (int stage = 0; stage < StageProfiler::numStages; ++stage)
+                            stageLoads->setProperty(StageProfiler::getStageName(stage), profile.getLoad(stage));
+
+                        stageLoads->setProperty("other", profile.getOtherLoad());
+                        entry.setProperty("stageLoads", juce::var(stageLoads));
+                       #else
+                        juce::ignoreUnused(profile);
+                       #endif
+                    }
+                }
+            }
+        }
+
+        processor.releaseResources();
+        return processor.getProfiler().getSnapshot();
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    // The processor's parameter state runs a timer, which needs the message manager
+    juce::ScopedJuceInitialiser_GUI libraryInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    auto quick = args.removeOptionIfFound("--quick");
+    auto label = args.removeValueForOption("--label");
+    auto jsonFile = args.removeValueForOption("--json");
+    auto profileFile = args.removeValueForOption("--profile");
+    auto checkOnly = args.removeOptionIfFound("--check");
+
+    if (profileFile.isNotEmpty() && ! CLARITIZER_PROFILING)
+    {
+        std::cerr << "--profile needs a build of the Profile configuration" << std::endl;
+        return 1;
+    }
+
+    EngineOptions options;
+
+    for (auto value = args.removeValueForOption("--interpolation"); value.isNotEmpty(); value = args.removeValueForOption("--interpolation"))
+    {
+        if (auto result = options.parseInterpolation(value); result.failed())
+        {
+            std::cerr << result.getErrorMessage() << std::endl;
+            return 1;
+        }
+    }
+
+    for (auto value = args.removeValueForOption("--saturation"); value.isNotEmpty(); value = args.removeValueForOption("--saturation"))
+    {
+        if (auto result = options.parseSaturation(value); result.failed())
+        {
+            std::cerr << result.getErrorMessage() << std::endl;
+            return 1;
+        }
+    }
+
+    Results results;
+    auto checksPassed = runAccuracyChecks(results);
+
+    if (checkOnly)
+        return checksPassed ? 0 : 1;
+
+    runDelayLineBenchmarks(results);
+    runLfoBenchmarks(results);
+    runSaturatorBenchmarks(results);
+    runToneFilterBenchmarks(results);
+    runEngineBenchmarks(results, options);
+    auto profile = runProcessBlockBenchmarks(results, quick, options);
+
+    if (jsonFile.isNotEmpty())
+    {
+        auto file = juce::File::getCurrentWorkingDirectory().getChildFile(jsonFile);
+
+        if (! results.writeJson(file, label))
+        {
+            std::cerr << "Can't write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    if (profileFile.isNotEmpty())
+    {
+        auto file = juce::File::getCurrentWorkingDirectory().getChildFile(profileFile);
+
+        if (! file.replaceWithText(profile.toText()))
+        {
+            std::cerr << "Can't write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    return checksPassed ? 0 : 1;
+}
@@ -0,0 +1,450 @@
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include <iostream>
+
+//==============================================================================
+// Claritizer Render - runs audio files through the plugin without a host
+//
+//   ClaritizerRender [options] <input files...>
+//
+//   --output <dir>        Where rendered files go (default: next to each input)
+//   --state <file>        Plugin state to start from, as XML or a binary chunk
+//   --save-state <file>   Writes the state after all options as XML and exits
+//   --mode <A-D>          Mode, also 0-3
+//   --clarity <0-1>       Dry/wet
+//   --time <0.1-3>        TIME scale
+//   --tone <0-1>          Tone
+//   --set <id=value>      Any other parameter by ID, in its own units
+//   --interpolation <[module=]modulated[/fixed]>
+//                         Delay interpolation of one module or all of them:
+//                         linear, hermite, lagrange3, or allpass when fixed
+//   --saturation <[module=]softclip|adaa>
+//                         Feedback saturator of one module or all of them
+//   --bpm <tempo>         Tempo the host would report, for tempo sync
+//   --double              Processes in double precision
+//   --block <samples>     Samples per processBlock call (default 8192)
+//   --threads <n>         Files rendered at once (default: one per core)
+//   --profile <file>      Writes where processBlock spent its time, per file
+//                         (Profile configuration only)
+//
+// Every worker owns one ClaritizerAudioProcessor and renders whole files with
+// it, so files run in parallel while each file stays in order. The processor
+// runs non-realtime, which turns on the offline-only oversampling. Output
+// starts where the input started, the oversampling latency is cut off the
+// front, and rendering carries on with silence until the tail the processor
+// reports has died away.
+//==============================================================================
+namespace
+{
+    constexpr int defaultBlockSize = 8192;
+
+    //==========================================================================
+    // Options shared by every render job
+    struct RenderSettings
+    {
+        juce::File outputDirectory;
+        juce::MemoryBlock state;        // Plugin state with every option applied
+        EngineOptions engineOptions;
+        double bpm = TempoSync::defaultBpm;
+        bool doublePrecision = false;
+        int blockSize = defaultBlockSize;
+    };
+
+    // Reports a fixed tempo, so tempo sync has something to lock to
+    struct FixedTempoPlayHead : juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo position;
+            position.setBpm(bpm);
+            position.setIsPlaying(true);
+            return position;
+        }
+
+        double bpm = TempoSync::defaultBpm;
+    };
+
+    //==========================================================================
+    // Processors are built on the message thread up front, one per worker,
+    // and lent to whichever job starts next
+    class ProcessorPool
+    {
+    public:
+        explicit ProcessorPool(int numProcessors)
+        {
+            for (int i = 0; i < numProcessors; ++i)
+                processors.add(new ClaritizerAudioProcessor());
+
+            for (auto* processor : processors)
+                available.add(processor);
+        }
+
+        ClaritizerAudioProcessor* acquire()
+        {
+            const juce::ScopedLock lock(mutex);
+            jassert(! available.isEmpty());     // There are never more jobs running than processors
+            return available.removeAndReturn(available.size() - 1);
+        }
+
+        void release(ClaritizerAudioProcessor* processor)
+        {
+            const juce::ScopedLock lock(mutex);
+            available.add(processor);
+        }
+
+    private:
+        juce::OwnedArray<ClaritizerAudioProcessor> processors;
+        juce::Array<ClaritizerAudioProcessor*> available;
+        juce::CriticalSection mutex;
+    };
+
+    //==========================================================================
+    juce::File getOutputFile(const juce::File& input, const RenderSettings& settings)
+    {
+        auto directory = settings.outputDirectory == juce::File() ? input.getParentDirectory()
+                                                                    : settings.outputDirectory;
+        auto extension = input.hasFileExtension("aif;aiff") ? input.getFileExtension() : juce::String(".wav");
+        return directory.getChildFile(input.getFileNameWithoutExtension() + "_claritized" + extension);
+    }
+
+    class RenderJob : public juce::ThreadPoolJob
+    {
+    public:
+        RenderJob(const juce::File& inputFile, const RenderSettings& renderSettings, ProcessorPool& processorPool)
+            : juce::ThreadPoolJob(inputFile.getFileName()),
+              input(inputFile), settings(renderSettings), pool(processorPool)
+        {
+        }
+
+        JobStatus runJob() override
+        {
+            auto* processor = pool.acquire();
+            auto startTime = juce::Time::getMillisecondCounterHiRes();
+            auto profileStart = processor->getProfiler().getSnapshot();
+
+            result = render(*processor);
+            profile = processor->getProfiler().getSnapshot() - profileStart;
+            syncDivisionOutOfReach = processor->isSyncDivisionOutOfReach();
+
+            if (result.wasOk())
+                realtimeFactor = renderedSeconds * 1000.0 / (juce::Time::getMillisecondCounterHiRes() - startTime);
+
+            processor->releaseResources();
+            pool.release(processor);
+            return jobHasFinished;
+        }
+
+        juce::String getSummary() const
+        {
+            if (result.failed())
+                return input.getFullPathName() + ": " + result.getErrorMessage();
+
+            return input.getFullPathName() + " -> " + getOutputFile(input, settings).getFullPathName()
+                 + " (" + juce::String(realtimeFactor, 1) + "x realtime)"
+                 + (syncDivisionOutOfReach ? ", sync division too long for the tempo" : "");
+        }
+
+        bool failed() const    { return result.failed(); }
+
+        const StageProfiler::Snapshot& getProfile() const    { return profile; }
+        const juce::File& getInput() const                   { return input; }
+
+    private:
+        juce::Result render(ClaritizerAudioProcessor& processor)
+        {
+            juce::AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+
+            if (reader == nullptr)
+                return juce::Result::fail(input.existsAsFile() ? "not a readable audio file" : "file not found");
+
+            auto numChannels = (int)reader->numChannels;
+            auto sampleRate = reader->sampleRate;
+
+            // The plugin runs any layout with the same channels in and out
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+            layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+
+            if (! processor.setBusesLayout(layout))
+                return juce::Result::fail("unsupported channel count " + juce::String(numChannels));
+
+            processor.setStateInformation(settings.state.getData(), (int)settings.state.getSize());
+            processor.setEngineOptions(settings.engineOptions);
+            processor.setPlayHead(&playHead);
+            playHead.bpm = settings.bpm;
+
+            processor.setNonRealtime(true);
+            processor.setProcessingPrecision(settings.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                      : juce::AudioProcessor::singlePrecision);
+            processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+            processor.prepareToPlay(sampleRate, settings.blockSize);
+
+            auto outputFile = getOutputFile(input, settings);
+            auto* format = formatManager.findFormatForFileExtension(outputFile.getFileExtension());
+            outputFile.deleteFile();
+            std::unique_ptr<juce::OutputStream> stream(outputFile.createOutputStream());
+
+            if (format == nullptr || stream == nullptr)
+                return juce::Result::fail("can't write " + outputFile.getFullPathName());
+
+            auto bitsPerSample = juce::jmax(16, (int)reader->bitsPerSample);
+            std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+                                                                                    (unsigned int)numChannels,
+                                                                                    bitsPerSample, reader->metadataValues, 0));
+
+            if (writer == nullptr)
+                return juce::Result::fail("can't write " + juce::String(bitsPerSample) + "-bit " + format->getFormatName());
+
+            stream.release();   // Now owned by the writer
+
+            if (settings.doublePrecision)
+                return process<double>(processor, *reader, *writer);
+
+            return process<float>(processor, *reader, *writer);
+        }
+
+        // Streams the file through in blocks, then feeds silence until the tail is out
+        template <typename SampleType>
+        juce::Result process(ClaritizerAudioProcessor& processor, juce::AudioFormatReader& reader,
+                             juce::AudioFormatWriter& writer)
+        {
+            auto numChannels = (int)reader.numChannels;
+            auto blockSize = settings.blockSize;
+            auto latency = (juce::int64)processor.getLatencySamples();
+
+            juce::AudioBuffer<float> ioBuffer(numChannels, blockSize);
+            juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+            juce::MidiBuffer midi;
+
+            juce::int64 position = 0, tailRemaining = -1, toSkip = latency;
+
+            while (tailRemaining != 0)
+            {
+                auto numSamples = blockSize;
+                ioBuffer.clear();
+
+                if (position < reader.lengthInSamples)
+                {
+                    numSamples = (int)juce::jmin((juce::int64)blockSize, reader.lengthInSamples - position);
+
+                    if (! reader.read(&ioBuffer, 0, numSamples, position, true, true))
+                        return juce::Result::fail("read error");
+                }
+                else
+                {
+                    // The tail is measured from the end of the input, plus the latency
+                    if (tailRemaining < 0)
+                        tailRemaining = juce::roundToInt(processor.getTailLengthSeconds() * reader.sampleRate) + latency;
+
+                    numSamples = (int)juce::jmin((juce::int64)blockSize, tailRemaining);
+                    tailRemaining -= numSamples;
+
+                    if (numSamples == 0)
+                        break;
+                }
+
+                position += numSamples;
+
+                if constexpr (std::is_same_v<SampleType, float>)
+                {
+                    ioBuffer.setSize(numChannels, numSamples, true, false, true);
+                    processor.processBlock(ioBuffer, midi);
+                }
+                else
+                {
+                    // Files are read and written as float either way
+                    ioBuffer.setSize(numChannels, numSamples, true, false, true);
+                    buffer.makeCopyOf(ioBuffer, true);
+                    processor.processBlock(buffer, midi);
+                    ioBuffer.makeCopyOf(buffer, true);
+                }
+
+                // Drop the samples the oversampling delayed everything by
+                auto skip = (int)juce::jmin((juce::int64)numSamples, toSkip);
+                toSkip -= skip;
+
+                if (skip < numSamples && ! writer.writeFromAudioSampleBuffer(ioBuffer, skip, numSamples - skip))
+                    return juce::Result::fail("write error");
+
+                ioBuffer.setSize(numChannels, blockSize, false, false, true);
+            }
+
+            renderedSeconds = (double)position / reader.sampleRate;
+            return juce::Result::ok();
+        }
+
+        juce::File input;
+        const RenderSettings& settings;
+        ProcessorPool& pool;
+        FixedTempoPlayHead playHead;
+
+        juce::Result result = juce::Result::ok();
+        double renderedSeconds = 0.0, realtimeFactor = 0.0;
+        StageProfiler::Snapshot profile;
+        bool syncDivisionOutOfReach = false;
+    };
+
+    //==========================================================================
+    // Sets a parameter in its own units (e.g. TIME 1.5, mode 2), not 0-1
+    bool setParameter(ClaritizerAudioProcessor& processor, const juce::String& id, float value)
+    {
+        auto* parameter = processor.parameters.getParameter(id);
+
+        if (parameter == nullptr)
+            return false;
+
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        return true;
+    }
+
+    bool loadState(ClaritizerAudioProcessor& processor, const juce::File& file)
+    {
+        juce::MemoryBlock data;
+
+        if (! file.loadFileAsData(data))
+            return false;
+
+        // Either the parameter tree as XML or a chunk saved by a host
+        if (auto xml = juce::parseXML(file))
+            juce::AudioProcessor::copyXmlToBinary(*xml, data);
+
+        processor.setStateInformation(data.getData(), (int)data.getSize());
+        return true;
+    }
+
+    int fail(const juce::String& message)
+    {
+        std::cerr << message << std::endl;
+        return 1;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI libraryInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    RenderSettings settings;
+    settings.doublePrecision = args.removeOptionIfFound("--double");
+
+    auto blockSize = args.removeValueForOption("--block");
+
+    if (blockSize.isNotEmpty())
+        settings.blockSize = juce::jmax(32, blockSize.getIntValue());
+
+    auto bpm = args.removeValueForOption("--bpm");
+
+    if (bpm.isNotEmpty())
+        settings.bpm = juce::jmax(1.0, bpm.getDoubleValue());
+
+    // Every option is applied to one processor whose state all workers copy
+    ClaritizerAudioProcessor reference;
+
+    auto stateFile = args.removeValueForOption("--state");
+
+    if (stateFile.isNotEmpty() && ! loadState(reference, juce::File::getCurrentWorkingDirectory().getChildFile(stateFile)))
+        return fail("Can't read state file " + stateFile);
+
+    auto mode = args.removeValueForOption("--mode").trim().toUpperCase();
+
+    if (mode.isNotEmpty())
+    {
+        auto index = mode.containsOnly("ABCD") && mode.length() == 1 ? (int)(mode[0] - 'A') : mode.getIntValue();
+        setParameter(reference, "mode", (float)juce::jlimit(0, 3, index));
+    }
+
+    for (auto id : { "clarity", "time", "tone" })
+    {
+        auto value = args.removeValueForOption("--" + juce::String(id));
+
+        if (value.isNotEmpty())
+            setParameter(reference, id, value.getFloatValue());
+    }
+
+    for (auto value = args.removeValueForOption("--set"); value.isNotEmpty(); value = args.removeValueForOption("--set"))
+        if (! setParameter(reference, value.upToFirstOccurrenceOf("=", false, false).trim(),
+                           value.fromFirstOccurrenceOf("=", false, false).getFloatValue()))
+            return fail("Unknown parameter in --set " + value);
+
+    for (auto value = args.removeValueForOption("--interpolation"); value.isNotEmpty(); value = args.removeValueForOption("--interpolation"))
+        if (auto result = settings.engineOptions.parseInterpolation(value); result.failed())
+            return fail(result.getErrorMessage());
+
+    for (auto value = args.removeValueForOption("--saturation"); value.isNotEmpty(); value = args.removeValueForOption("--saturation"))
+        if (auto result = settings.engineOptions.parseSaturation(value); result.failed())
+            return fail(result.getErrorMessage());
+
+    reference.getStateInformation(settings.state);
+
+    auto saveState = args.removeValueForOption("--save-state");
+
+    if (saveState.isNotEmpty())
+    {
+        auto xml = reference.parameters.copyState().createXml();
+        return xml->writeTo(juce::File::getCurrentWorkingDirectory().getChildFile(saveState)) ? 0 : fail("Can't write " + saveState);
+    }
+
+    auto output = args.removeValueForOption("--output");
+
+    if (output.isNotEmpty())
+    {
+        settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(output);
+
+        if (! settings.outputDirectory.createDirectory())
+            return fail("Can't create " + output);
+    }
+
+    auto profileFile = args.removeValueForOption("--profile");
+
+    if (profileFile.isNotEmpty() && ! CLARITIZER_PROFILING)
+        return fail("--profile needs a build of the Profile configuration");
+
+    auto threads = args.removeValueForOption("--threads").getIntValue();
+    auto numThreads = threads > 0 ? threads : juce::SystemStats::getNumCpus();
+
+    juce::Array<juce::File> inputs;
+
+    for (auto& arg : args.arguments)
+    {
+        if (arg.isOption())
+            return fail("Unknown option " + arg.text);
+
+        inputs.add(arg.resolveAsFile());
+    }
+
+    if (inputs.isEmpty())
+        return fail("Usage: ClaritizerRender [options] <input files...>");
+
+    numThreads = juce::jmin(numThreads, inputs.size());
+
+    ProcessorPool processors(numThreads);
+    juce::ThreadPool threadPool(numThreads);
+    juce::OwnedArray<RenderJob> jobs;
+
+    for (auto& input : inputs)
+        threadPool.addJob(jobs.add(new RenderJob(input, settings, processors)), false);
+
+    while (threadPool.getNumJobs() > 0)
+        juce::Thread::sleep(50);
+
+    auto numFailed = 0;
+    juce::String profile;
+
+    for (auto* job : jobs)
+    {
+        std::cout << job->getSummary() << std::endl;
+        numFailed += job->failed() ? 1 : 0;
+
+        profile << job->getInput().getFullPathName() << juce::newLine
+                << job->getProfile().toText() << juce::newLine;
+    }
+
+    if (profileFile.isNotEmpty() && ! juce::File::getCurrentWorkingDirectory().getChildFile(profileFile).replaceWithText(profile))
+        return fail("Can't write " + profileFile);
+
+    return numFailed == 0 ? 0 : 1;
+}